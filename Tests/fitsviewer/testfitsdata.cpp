@@ -11,6 +11,8 @@
 #include <QtTest>
 
 #include "testfitsdata.h"
+#include "fitsviewer/fitsconversion.h"
+#include "fitsviewer/fitssepdetector.h"
 
 TestFitsData::TestFitsData(QObject *parent) : QObject(parent)
 {
@@ -184,4 +186,116 @@ void TestFitsData::testSEPAlgorithmBenchmark()
     QBENCHMARK { fd->findStars(ALGORITHM_SEP); }
 }
 
+void TestFitsData::testSEPTiling()
+{
+    // Tiles of 512 pixels split the 1280x1024 frame in 6 tiles
+    QList<Edge *> single, tiled;
+    QCOMPARE(FITSSEPDetector(fd).configure("TILE_SIZE", 0).findSources(single), 100);
+    QCOMPARE(FITSSEPDetector(fd).configure("TILE_SIZE", 512).findSources(tiled), 100);
+
+    // The background of the tiles differs a little from the background of the frame, which may change a few
+    // of the stars selected for their size, but not the mean HFR
+    int matches = 0;
+    double singleHFR = 0, tiledHFR = 0;
+    for (Edge * star : tiled)
+    {
+        tiledHFR += star->HFR;
+        for (Edge * other : single)
+        {
+            if (qAbs(star->x - other->x) <= 1 && qAbs(star->y - other->y) <= 1)
+            {
+                matches++;
+                break;
+            }
+        }
+    }
+    for (Edge * star : single)
+        singleHFR += star->HFR;
+
+    qDeleteAll(single);
+    qDeleteAll(tiled);
+
+    QVERIFY(matches >= 90);
+    QVERIFY(qAbs(singleHFR - tiledHFR) / 100 < 0.01);
+}
+
+void TestFitsData::testFloatConversion()
+{
+    // The simulated frame has unsigned 16-bit pixels
+    QCOMPARE(fd->property("dataType").toInt(), TUSHORT);
+    uint16_t const * pixels = reinterpret_cast<uint16_t const *>(fd->getImageBuffer());
+    const int width = fd->width(), height = fd->height();
+
+    // The whole frame, then a subframe whose rows are not a multiple of the vector width
+    FITSFloatBuffer frame = FITSConversion::toFloat(fd);
+    QVERIFY(!frame.isNull());
+    QCOMPARE(frame.size(), static_cast<size_t>(width * height));
+    int mismatches = 0;
+    for (int i = 0; i < width * height; i++)
+        if (frame.data()[i] != pixels[i])
+            mismatches++;
+    QCOMPARE(mismatches, 0);
+
+    const QRect box(13, 7, 61, 29);
+    FITSFloatBuffer subframe = FITSConversion::toFloat(fd, box);
+    QVERIFY(!subframe.isNull());
+    QCOMPARE(subframe.size(), static_cast<size_t>(box.width() * box.height()));
+    for (int y = 0; y < box.height(); y++)
+        for (int x = 0; x < box.width(); x++)
+            if (subframe.data()[y * box.width() + x] != pixels[(box.y() + y) * width + box.x() + x])
+                mismatches++;
+    QCOMPARE(mismatches, 0);
+
+    // Rectangles out of the frame are not converted
+    QVERIFY(FITSConversion::toFloat(fd, QRect(width - 10, 0, 20, 20)).isNull());
+}
+
+void TestFitsData::testLoadFitsFromMemory()
+{
+    QFile file(m_FitsFixture);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray buffer = file.readAll();
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filename = dir.filePath("memory.fits");
+
+    FITSData * d = new FITSData();
+    QVERIFY(d->loadFITSFromMemory(filename, buffer.data(), buffer.size(), true));
+
+    // The data does not depend on the buffer of the caller, and is not written to disk
+    buffer.fill(0);
+    QVERIFY(d->isInMemory());
+    QVERIFY(!QFile::exists(filename));
+    QCOMPARE(d->getMax(), fd->getMax());
+    QCOMPARE(d->getMin(), fd->getMin());
+
+    // Keywords are added in memory
+    QVariant value;
+    QVERIFY(!d->getRecordValue("FILTER", value));
+    QVERIFY(d->setRecordValue("FILTER", "Luminance", "Filter name"));
+    QVERIFY(d->getRecordValue("FILTER", value));
+    QCOMPARE(value.toString(), QString("Luminance"));
+
+    // The header of a file loaded from disk is not modified
+    QVERIFY(!fd->isInMemory());
+    QVERIFY(!fd->setRecordValue("FILTER", "Luminance", "Filter name"));
+
+    // Once persisted, the file has the keyword
+    QVERIFY(d->persistFile());
+    QVERIFY(!d->isInMemory());
+    QVERIFY(QFile::exists(filename));
+    d->setAutoRemoveTemporaryFITS(false);
+    delete d;
+
+    d = new FITSData();
+    QFuture<bool> worker = d->loadFITS(filename);
+    QTRY_VERIFY_WITH_TIMEOUT(worker.isFinished(), 5000);
+    QVERIFY(worker.result());
+    QVERIFY(d->getRecordValue("FILTER", value));
+    QCOMPARE(value.toString(), QString("Luminance"));
+    QCOMPARE(d->getMax(), fd->getMax());
+    delete d;
+}
+
 QTEST_GUILESS_MAIN(TestFitsData)
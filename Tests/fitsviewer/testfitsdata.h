@@ -40,6 +40,9 @@ private slots:
     void testGradientAlgorithmBenchmark();
     void testThresholdAlgorithmBenchmark();
     void testSEPAlgorithmBenchmark();
+    void testSEPTiling();
+    void testFloatConversion();
+    void testLoadFitsFromMemory();
     void testFocusHFR();
     void runFocusHFR(const QString &filename, int nstars, float hfr);
     void testBahtinovFocusHFR();
@@ -0,0 +1,234 @@
+/***************************************************************************
+                benchmark_skymap.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * Renders a scripted sequence of sky map views into an offscreen image, and reports the
+ * percentiles of the frame times of each step. Runs without a display, using the offscreen
+ * platform plugin unless QT_QPA_PLATFORM says otherwise.
+ *
+ * Usage: benchmark_skymap [--frames N] [--width W] [--height H] [--csv file]
+ */
+
+#include "kspaths.h"
+#include "kstars.h"
+#include "kstarsdata.h"
+#include "Options.h"
+#include "skymap.h"
+#include "skyqpainter.h"
+#include "projections/projector.h"
+#include "skycomponents/skymapcomposite.h"
+
+#include <KTipDialog>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QMetaEnum>
+#include <QPainterPath>
+#include <QStandardPaths>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace
+{
+struct Step
+{
+    QString name;
+    /// Prepares the given frame of the step
+    std::function<void(int frame)> prepare;
+};
+
+/// Nearest-rank percentile of sorted values
+double percentile(const QVector<double> &sorted, double p)
+{
+    int const rank = qBound(0, int(std::ceil(p / 100.0 * sorted.size())) - 1, sorted.size() - 1);
+    return sorted[rank];
+}
+
+/// Draw the sky map as SkyMapQDraw does, and return the elapsed time in milliseconds
+double renderFrame(SkyMap *map, QImage &image)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    map->setupProjector();
+
+    SkyQPainter psky(map, &image);
+    psky.begin();
+    psky.drawSkyBackground();
+
+    QPainterPath path;
+    path.addPolygon(map->projector()->clipPoly());
+    psky.setClipPath(path);
+    psky.setClipping(true);
+
+    KStarsData::Instance()->skyComposite()->draw(&psky);
+    psky.end();
+
+    return timer.nsecsElapsed() / 1e6;
+}
+
+void setJulianDay(long double jd)
+{
+    KStarsData *data = KStarsData::Instance();
+    data->changeDateTime(KStarsDateTime(jd));
+    data->updateTime(data->geo(), false);
+}
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setAttribute(Qt::AA_Use96Dpi, true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sky map rendering benchmark");
+    parser.addHelpOption();
+    parser.addOption({ "frames", "Number of frames rendered for each step.", "N", "20" });
+    parser.addOption({ "width", "Width of the rendered image.", "pixels", "1920" });
+    parser.addOption({ "height", "Height of the rendered image.", "pixels", "1080" });
+    parser.addOption({ "csv", "Write the time of each frame to this file.", "file" });
+    parser.process(app);
+
+    const int frames = qMax(1, parser.value("frames").toInt());
+    const QSize size(parser.value("width").toInt(), parser.value("height").toInt());
+
+    // Use a throw-away user configuration, and skip the startup wizard and tips
+    QStandardPaths::setTestModeEnabled(true);
+    QDir().mkpath(KSPaths::writableLocation(QStandardPaths::GenericDataLocation));
+    Options::setRunStartupWizard(false);
+    KTipDialog::setShowOnStart(false);
+
+    // Loads all catalogs before returning
+    KStars::createInstance(false, false);
+    KStars *kstars = KStars::Instance();
+    KStarsData *data = kstars->data();
+    SkyMap *map = kstars->map();
+
+    GeoLocation *geo = data->locationNamed("Greenwich");
+    if (geo)
+        data->setLocation(*geo);
+
+    map->setFixedSize(size);
+    QApplication::processEvents();
+
+    const long double J2020 = 2458849.5;
+    QImage image(map->size(), QImage::Format_ARGB32_Premultiplied);
+
+    auto lookAt = [map](double alt, double az, double zoom, Projector::Projection projection)
+    {
+        Options::setProjection(projection);
+        Options::setZoomFactor(zoom);
+        map->setFocusAltAz(dms(alt), dms(az));
+        map->setDestination(*map->focus());
+    };
+
+    QVector<Step> steps;
+
+    // Deeper zoom levels bring in the dynamically loaded star catalogs
+    for (double zoom : { 250.0, 2000.0, 20000.0, 200000.0 })
+    {
+        steps.append({ QString("zoom %1").arg(zoom), [ = ](int)
+        {
+            setJulianDay(J2020);
+            lookAt(60, 180, zoom, Projector::Lambert);
+        } });
+    }
+
+    const QMetaEnum projections = QMetaEnum::fromType<Projector::Projection>();
+    for (int i = 0; i < Projector::UnknownProjection; ++i)
+    {
+        steps.append({ QString("projection %1").arg(projections.valueToKey(i)), [ = ](int)
+        {
+            lookAt(60, 180, 1000, static_cast<Projector::Projection>(i));
+        } });
+    }
+
+    // Every frame is a new view, so nothing can be reused from the previous frame
+    steps.append({ "slew", [ = ](int frame)
+    {
+        lookAt(45, 3.0 * frame, 2000, Projector::Lambert);
+    } });
+
+    // Alternate between dates 6000 years apart, beyond the re-indexing interval of the stars,
+    // so that StarComponent::reindexAll() runs on every frame
+    steps.append({ "time jump", [ = ](int frame)
+    {
+        setJulianDay(J2020 + (frame % 2 ? 6000 * 365.25 : 0));
+        lookAt(60, 180, 1000, Projector::Lambert);
+    } });
+
+    QFile csv;
+    QTextStream csvOut;
+    if (parser.isSet("csv"))
+    {
+        csv.setFileName(parser.value("csv"));
+        if (!csv.open(QIODevice::WriteOnly | QIODevice::Text))
+        {
+            qWarning() << "Cannot write" << csv.fileName() << ":" << csv.errorString();
+            return 1;
+        }
+        csvOut.setDevice(&csv);
+        csvOut << "step,frame,milliseconds\n";
+    }
+
+    QTextStream out(stdout);
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+        .arg("step", -24).arg("frames", 7).arg("p50 ms", 9).arg("p90 ms", 9).arg("p99 ms", 9).arg("max ms", 9);
+
+    // Warm up caches and the star block loader
+    steps.first().prepare(0);
+    renderFrame(map, image);
+
+    for (const Step &step : steps)
+    {
+        QVector<double> times;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            step.prepare(frame);
+            times.append(renderFrame(map, image));
+            if (csv.isOpen())
+                csvOut << step.name << ',' << frame << ',' << times.last() << '\n';
+
+            // Let the star block loader report, as the sky map would between frames
+            QApplication::processEvents();
+        }
+
+        std::sort(times.begin(), times.end());
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+            .arg(step.name, -24)
+            .arg(frames, 7)
+            .arg(percentile(times, 50), 9, 'f', 2)
+            .arg(percentile(times, 90), 9, 'f', 2)
+            .arg(percentile(times, 99), 9, 'f', 2)
+            .arg(times.last(), 9, 'f', 2);
+        out.flush();
+    }
+
+    kstars->close();
+    delete kstars;
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/***************************************************************************
+             test_chebyshevephemeris.cpp  -  KStars Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "test_chebyshevephemeris.h"
+
+#include "ksnumbers.h"
+#include "Options.h"
+#include "auxiliary/dms.h"
+#include "skyobjects/chebyshevephemeris.h"
+#include "skyobjects/ksmoon.h"
+#include "skyobjects/ksplanet.h"
+
+#include <cmath>
+
+namespace
+{
+// Interpolated and series positions must agree to this many arcseconds
+const double arcsecTolerance = 0.01;
+
+/// Angle between two positions given by their ecliptic longitude and latitude, in arcseconds
+double separation(const dms &lon1, const dms &lat1, const dms &lon2, const dms &lat2)
+{
+    double sinB1, cosB1, sinB2, cosB2;
+    lat1.SinCos(sinB1, cosB1);
+    lat2.SinCos(sinB2, cosB2);
+    const double cosSeparation = sinB1 * sinB2 + cosB1 * cosB2 * cos(lon1.radians() - lon2.radians());
+    return acos(qMin(1.0, cosSeparation)) / dms::DegToRad * 3600.0;
+}
+
+/// Irregularly spaced epochs over two centuries, so that they fall anywhere in their segment
+QVector<long double> epochs()
+{
+    QVector<long double> jds;
+    for (long double jd = 2415020.5; jd < 2488070.5; jd += 36.61803)
+        jds.append(jd);
+    return jds;
+}
+}
+
+void TestChebyshevEphemeris::initTestCase()
+{
+    m_EphemerisCache = Options::ephemerisCache();
+}
+
+void TestChebyshevEphemeris::cleanupTestCase()
+{
+    Options::setEphemerisCache(m_EphemerisCache);
+}
+
+void TestChebyshevEphemeris::testInterpolation()
+{
+    // A smooth function is interpolated well below its own accuracy, including across segments
+    ChebyshevEphemeris cache(1.0, 12);
+    auto series = [](double t, double xyz[3])
+    {
+        xyz[0] = cos(t);
+        xyz[1] = sin(t);
+        xyz[2] = 0.1 * t * t;
+    };
+
+    for (double t = -10; t < 10; t += 0.0137)
+    {
+        double xyz[3];
+        cache.evaluate(t, xyz, series);
+        QVERIFY(fabs(xyz[0] - cos(t)) < 1e-12);
+        QVERIFY(fabs(xyz[1] - sin(t)) < 1e-12);
+        QVERIFY(fabs(xyz[2] - 0.1 * t * t) < 1e-12);
+    }
+    QCOMPARE(cache.segmentCount(), 20);
+
+    cache.clear();
+    QCOMPARE(cache.segmentCount(), 0);
+}
+
+void TestChebyshevEphemeris::testPlanets()
+{
+    QVector<KSPlanet *> planets;
+    for (int i = KSPlanetBase::MERCURY; i <= KSPlanetBase::NEPTUNE; ++i)
+        planets.append(new KSPlanet(i));
+    planets.append(new KSPlanet("Earth"));
+
+    for (KSPlanet *planet : planets)
+    {
+        if (!planet->loadData())
+        {
+            qDeleteAll(planets);
+            QSKIP("The VSOP87 data files are not installed.");
+        }
+
+        double maxSeparation = 0, maxDistance = 0;
+        for (long double jd : epochs())
+        {
+            KSNumbers num(jd);
+            EclipticPosition series, interpolated;
+
+            Options::setEphemerisCache(false);
+            planet->calcEcliptic(num.julianMillenia(), series);
+            Options::setEphemerisCache(true);
+            planet->calcEcliptic(num.julianMillenia(), interpolated);
+
+            maxSeparation = qMax(maxSeparation, separation(series.longitude, series.latitude,
+                                                           interpolated.longitude, interpolated.latitude));
+            maxDistance   = qMax(maxDistance, fabs(series.radius - interpolated.radius) / series.radius);
+        }
+
+        qDebug() << planet->name() << "differs by at most" << maxSeparation << "arcsec";
+        QVERIFY(maxSeparation < arcsecTolerance);
+        QVERIFY(maxDistance < 1e-7);
+    }
+
+    qDeleteAll(planets);
+}
+
+void TestChebyshevEphemeris::testMoon()
+{
+    KSMoon moon;
+    if (!moon.loadData())
+        QSKIP("The lunar data files are not installed.");
+
+    double maxSeparation = 0, maxDistance = 0;
+    for (long double jd : epochs())
+    {
+        KSNumbers num(jd);
+
+        Options::setEphemerisCache(false);
+        QVERIFY(moon.findGeocentricPosition(&num, nullptr));
+        const dms lon = moon.ecLong(), lat = moon.ecLat();
+        const double distance = moon.rearth();
+
+        Options::setEphemerisCache(true);
+        QVERIFY(moon.findGeocentricPosition(&num, nullptr));
+
+        maxSeparation = qMax(maxSeparation, separation(lon, lat, moon.ecLong(), moon.ecLat()));
+        maxDistance   = qMax(maxDistance, fabs(distance - moon.rearth()) / distance);
+    }
+
+    qDebug() << "The Moon differs by at most" << maxSeparation << "arcsec";
+    QVERIFY(maxSeparation < arcsecTolerance);
+    QVERIFY(maxDistance < 1e-7);
+}
+
+QTEST_GUILESS_MAIN(TestChebyshevEphemeris)
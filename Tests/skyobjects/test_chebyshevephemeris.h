@@ -0,0 +1,39 @@
+/***************************************************************************
+              test_chebyshevephemeris.h  -  KStars Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+/**
+ * @class TestChebyshevEphemeris
+ * @short Checks the interpolated positions of the planets and the Moon against their series
+ */
+class TestChebyshevEphemeris : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testInterpolation();
+    void testPlanets();
+    void testMoon();
+
+  private:
+    bool m_EphemerisCache { true };
+};
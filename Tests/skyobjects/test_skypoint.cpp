@@ -93,4 +93,42 @@ void TestSkyPoint::testPrecession()
     verify(p, 169.71785991, 45.30132855, arcsecPrecision);
 }
 
+void TestSkyPoint::testEquatorialToHorizontalBulk()
+{
+    // The bulk conversion must agree with the conversion of one point at a time
+    const CachingDms LST(123.456), lat(48.1);
+
+    QVector<SkyPoint> points, reference;
+    for (double ra = 0; ra < 360; ra += 7.5)
+    {
+        for (double dec = -89; dec <= 89; dec += 4.75)
+        {
+            points.append(SkyPoint(dms(ra), dms(dec)));
+            reference.append(points.last());
+            reference.last().EquatorialToHorizontal(&LST, &lat);
+        }
+    }
+
+    QVector<SkyPoint *> pointers;
+    for (SkyPoint &p : points)
+        pointers.append(&p);
+
+    for (bool fast : { false, true })
+    {
+        // Single precision is good to a fraction of an arcsecond
+        const double tolerance = fast ? 1e-4 : 1e-6;
+
+        SkyPoint::EquatorialToHorizontal(pointers.constData(), pointers.size(), &LST, &lat, fast);
+        for (int i = 0; i < points.size(); ++i)
+        {
+            QVERIFY(fabs(points[i].alt().Degrees() - reference[i].alt().Degrees()) < tolerance);
+
+            // Azimuth is meaningless at the zenith, and wraps around at north
+            double dAz = fabs(points[i].az().Degrees() - reference[i].az().Degrees());
+            dAz        = qMin(dAz, 360.0 - dAz);
+            QVERIFY(dAz * cos(reference[i].alt().radians()) < tolerance);
+        }
+    }
+}
+
 QTEST_GUILESS_MAIN(TestSkyPoint)
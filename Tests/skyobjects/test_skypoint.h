@@ -41,6 +41,7 @@ class TestSkyPoint : public QObject
 
   private slots:
     void testPrecession();
+    void testEquatorialToHorizontalBulk();
 };
 
 #endif
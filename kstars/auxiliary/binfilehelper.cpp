@@ -40,6 +40,7 @@ BinFileHelper::~BinFileHelper()
 
 void BinFileHelper::init()
 {
+    unmapFile();
     if (fileHandle)
         fclose(fileHandle);
 
@@ -85,6 +86,7 @@ FILE *BinFileHelper::openFile(const QString &fileName)
 {
     QString FilePath = KSPaths::locate(QStandardPaths::GenericDataLocation, fileName);
     init();
+    filePath             = FilePath;
     QByteArray b         = FilePath.toLatin1();
     const char *filepath = b.data();
 
@@ -287,10 +289,66 @@ bool BinFileHelper::readHeader()
 
 void BinFileHelper::closeFile()
 {
+    unmapFile();
     fclose(fileHandle);
     fileHandle = nullptr;
 }
 
+bool BinFileHelper::mapFile()
+{
+    if (mappedData)
+        return true;
+
+    if (!fileHandle || !indexUpdated || filePath.isEmpty())
+        return false;
+
+    mappedFile.setFileName(filePath);
+    if (!mappedFile.open(QIODevice::ReadOnly))
+    {
+        errorMessage = QStringLiteral("Could not open %1 for mapping: %2").arg(filePath, mappedFile.errorString());
+        return false;
+    }
+
+    mappedSize = mappedFile.size();
+    mappedData = mappedFile.map(0, mappedSize);
+    if (!mappedData)
+    {
+        errorMessage = QStringLiteral("Could not map %1: %2").arg(filePath, mappedFile.errorString());
+        mappedFile.close();
+        mappedSize = 0;
+        return false;
+    }
+
+    // The mapping stays valid after the QFile is closed, and we do not want to keep a second descriptor around
+    mappedFile.close();
+    return true;
+}
+
+void BinFileHelper::unmapFile()
+{
+    if (!mappedData)
+        return;
+
+    mappedFile.unmap(const_cast<uchar *>(mappedData));
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+void BinFileHelper::prefetchMapped(quint64 offset, quint64 length) const
+{
+    if (!mappedData || offset >= mappedSize)
+        return;
+
+    const quint64 end = qMin(offset + length, mappedSize);
+    const quint64 pageSize = 4096;
+    volatile uchar sink = 0;
+
+    for (quint64 i = offset; i < end; i += pageSize)
+        sink ^= mappedData[i];
+    sink ^= mappedData[end - 1];
+    Q_UNUSED(sink)
+}
+
 int BinFileHelper::getErrorNumber()
 {
     int err = errnum;
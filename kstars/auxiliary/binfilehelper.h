@@ -18,10 +18,12 @@
 
 #pragma once
 
+#include <QFile>
 #include <QString>
 #include <QVector>
 
 #include <cstdio>
+#include <cstring>
 
 class QString;
 
@@ -81,6 +83,78 @@ class BinFileHelper
      */
     void closeFile();
 
+    /**
+     * @short  Map the currently open file into memory
+     *
+     * Once the file is mapped, records can be read straight out of the mapping with
+     * mappedRecords() / readMappedRecord() instead of a fseek / fread pair per record.
+     * The mapping is read-only and shared with the page cache, so a large catalog costs
+     * no memory beyond what is actually touched.
+     * @note   To be called only after the header has been parsed
+     * @return true if the file was mapped, false if it could not be mapped (use fread then)
+     */
+    bool mapFile();
+
+    /**
+     * @short  Release the memory mapping of the file, if any
+     */
+    void unmapFile();
+
+    /**
+     * @return true if the file is currently mapped into memory
+     */
+    inline bool isMapped() const { return mappedData != nullptr; }
+
+    /**
+     * @short  Returns the records under the given index ID, in place in the mapped file
+     * @param  id  ID of the index entry
+     * @return Pointer to getRecordCount(id) consecutive records, or nullptr if the file is not mapped,
+     *         the index has not been read, the records are not of type T or they are not aligned for T
+     * @note   The records are stored exactly as in the file. If getByteSwap() is true, they must be copied
+     *         out with readMappedRecord() and swapped instead.
+     */
+    template <typename T>
+    inline const T *mappedRecords(int id) const
+    {
+        if (!mappedData || !indexUpdated || id < 0 || id >= indexOffset.size() || sizeof(T) != quint64(recordSize))
+            return nullptr;
+
+        quint64 offset = indexOffset.at(id);
+        if (offset + quint64(indexCount.at(id)) * sizeof(T) > mappedSize)
+            return nullptr;
+
+        const uchar *records = mappedData + offset;
+        if (reinterpret_cast<quintptr>(records) % alignof(T) != 0)
+            return nullptr;
+
+        return reinterpret_cast<const T *>(records);
+    }
+
+    /**
+     * @short  Fault in the pages of the mapped file covering the given range
+     *
+     * Meant to be called from a background thread so that a later read of the same range,
+     * e.g. under a lock held by the GUI thread, does not have to wait for the disk.
+     * @param  offset  Offset of the range from the beginning of the file
+     * @param  length  Length of the range in bytes
+     */
+    void prefetchMapped(quint64 offset, quint64 length) const;
+
+    /**
+     * @short  Copy a single record out of the mapped file
+     * @param  offset  Offset of the record from the beginning of the file
+     * @param  record  Structure to copy the record into
+     * @return true on success, false if the file is not mapped or the record lies beyond its end
+     */
+    template <typename T>
+    inline bool readMappedRecord(quint64 offset, T *record) const
+    {
+        if (!mappedData || offset + sizeof(T) > mappedSize)
+            return false;
+        memcpy(record, mappedData + offset, sizeof(T));
+        return true;
+    }
+
     /**
      * @short   Get error number
      * @return  A number corresponding to the error
@@ -241,6 +315,14 @@ class BinFileHelper
 
     /// Handle to the file.
     FILE *fileHandle { nullptr};
+    /// Full path of the currently open file
+    QString filePath;
+    /// File used to memory map the data, see mapFile()
+    QFile mappedFile;
+    /// Start of the memory mapped file, nullptr if it is not mapped
+    const uchar *mappedData { nullptr };
+    /// Size of the memory mapped region in bytes
+    quint64 mappedSize { 0 };
     /// Stores offsets corresponding to each index table entry
     QVector<unsigned long> indexOffset;
     /// Stores number of records under each index table entry
@@ -18,6 +18,170 @@
 #include "fitsviewer/fitsdata.h"
 #include "fitsviewer/fitsview.h"
 
+#include "ekos_debug.h"
+
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+/// Statistics of the calibrated pixels of a band of rows, merged once all bands are done
+struct CalibrationStatistics
+{
+    double min { std::numeric_limits<double>::max() };
+    double max { std::numeric_limits<double>::lowest() };
+    double sum { 0 };
+    double squaredSum { 0 };
+    int64_t count { 0 };
+
+    void merge(CalibrationStatistics const &other)
+    {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum += other.sum;
+        squaredSum += other.squaredSum;
+        count += other.count;
+    }
+};
+
+/* Subtract a row of dark pixels from a row of light pixels, clamping at zero.
+ * The branch-free form lets the compiler vectorize the loop. */
+template <typename T>
+inline void subtractRow(T *light, T const *dark, int width)
+{
+    for (int j = 0; j < width; j++)
+        light[j] = (light[j] > dark[j]) ? static_cast<T>(light[j] - dark[j]) : static_cast<T>(0);
+}
+
+#ifdef __SSE2__
+// Most cameras send 8 or 16-bit unsigned pixels, for which SSE2 has a saturating subtraction
+template <>
+inline void subtractRow<uint8_t>(uint8_t *light, uint8_t const *dark, int width)
+{
+    int j = 0;
+    for (; j + 16 <= width; j += 16)
+    {
+        __m128i const l = _mm_loadu_si128(reinterpret_cast<__m128i const *>(light + j));
+        __m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dark + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(light + j), _mm_subs_epu8(l, d));
+    }
+    for (; j < width; j++)
+        light[j] = (light[j] > dark[j]) ? light[j] - dark[j] : 0;
+}
+
+template <>
+inline void subtractRow<uint16_t>(uint16_t *light, uint16_t const *dark, int width)
+{
+    int j = 0;
+    for (; j + 8 <= width; j += 8)
+    {
+        __m128i const l = _mm_loadu_si128(reinterpret_cast<__m128i const *>(light + j));
+        __m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dark + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(light + j), _mm_subs_epu16(l, d));
+    }
+    for (; j < width; j++)
+        light[j] = (light[j] > dark[j]) ? light[j] - dark[j] : 0;
+}
+#endif
+
+/* Accumulate the statistics of a row that was just calibrated, while it is still in cache.
+ * Sums of 8 and 16-bit pixels are exact in 64-bit integers, which are also faster to add. */
+template <typename T>
+inline void accumulateRow(T const *row, int width, CalibrationStatistics &stats)
+{
+    using Sum = typename std::conditional < std::is_integral<T>::value && sizeof(T) <= 2, int64_t, double >::type;
+
+    T min = row[0], max = row[0];
+    Sum sum = 0, squaredSum = 0;
+    for (int j = 0; j < width; j++)
+    {
+        Sum const value = row[j];
+        min = std::min(min, row[j]);
+        max = std::max(max, row[j]);
+        sum += value;
+        squaredSum += value * value;
+    }
+
+    stats.min = std::min(stats.min, static_cast<double>(min));
+    stats.max = std::max(stats.max, static_cast<double>(max));
+    stats.sum += sum;
+    stats.squaredSum += squaredSum;
+    stats.count += width;
+}
+
+template <typename T>
+CalibrationStatistics subtractRows(T *light, int lightW, T const *dark, int darkW, int firstRow, int lastRow)
+{
+    CalibrationStatistics stats;
+
+    light += static_cast<int64_t>(firstRow) * lightW;
+    dark += static_cast<int64_t>(firstRow) * darkW;
+
+    for (int i = firstRow; i < lastRow; i++)
+    {
+        subtractRow<T>(light, dark, lightW);
+        accumulateRow<T>(light, lightW, stats);
+        light += lightW;
+        dark += darkW;
+    }
+
+    return stats;
+}
+
+/* Subtract the dark from the first channel of the light in bands of rows on the global thread pool,
+ * and return the light statistics updated for that channel. */
+template <typename T>
+FITSData::Statistic subtractDark(FITSData::Statistic stats, T *light, T const *dark, int darkW)
+{
+    int const lightW = stats.width;
+    int const lightH = stats.height;
+
+    if (lightW == 0 || lightH == 0)
+        return stats;
+
+    int const bands = qBound(1, QThreadPool::globalInstance()->maxThreadCount(), lightH);
+    int const rowsPerBand = (lightH + bands - 1) / bands;
+
+    // The calling thread takes the first band
+    QList<QFuture<CalibrationStatistics>> futures;
+    for (int firstRow = rowsPerBand; firstRow < lightH; firstRow += rowsPerBand)
+    {
+        int const lastRow = std::min(firstRow + rowsPerBand, lightH);
+        futures.append(QtConcurrent::run([light, lightW, dark, darkW, firstRow, lastRow]()
+        {
+            return subtractRows<T>(light, lightW, dark, darkW, firstRow, lastRow);
+        }));
+    }
+
+    CalibrationStatistics result = subtractRows<T>(light, lightW, dark, darkW, 0, std::min(rowsPerBand, lightH));
+    for (QFuture<CalibrationStatistics> &future : futures)
+        result.merge(future.result());
+
+    double const mean = result.sum / result.count;
+    double const variance = std::max(0.0, result.squaredSum / result.count - mean * mean);
+
+    stats.min[0]    = result.min;
+    stats.max[0]    = result.max;
+    stats.mean[0]   = mean;
+    stats.stddev[0] = sqrt(variance);
+    // FIXME That's not really SNR, same as FITSData::calculateStats
+    stats.SNR       = stats.mean[0] / stats.stddev[0];
+
+    return stats;
+}
+}
+
 namespace Ekos
 {
 DarkLibrary *DarkLibrary::_DarkLibrary = nullptr;
@@ -33,6 +197,7 @@ DarkLibrary *DarkLibrary::Instance()
 DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
 {
     KStarsData::Instance()->userdb()->GetAllDarkFrames(darkFrames);
+    buildDarkIndex();
 
     subtractParams.duration    = 0;
     subtractParams.offsetX     = 0;
@@ -49,72 +214,185 @@ DarkLibrary::DarkLibrary(QObject *parent) : QObject(parent)
 
 DarkLibrary::~DarkLibrary()
 {
+    for (auto &preload : darkPreloads)
+    {
+        preload.second.waitForFinished();
+        delete preload.first;
+    }
+
     qDeleteAll(darkFiles);
+    qDeleteAll(darkFilesPendingDelete);
 }
 
 void DarkLibrary::refreshFromDB()
 {
     KStarsData::Instance()->userdb()->GetAllDarkFrames(darkFrames);
+    buildDarkIndex();
 }
 
-FITSData *DarkLibrary::getDarkFrame(ISD::CCDChip *targetChip, double duration)
+QString DarkLibrary::darkIndexKey(const QString &ccd, int chip, int binX, int binY)
 {
-    for (auto &map : darkFrames)
+    return QString("%1/%2/%3x%4").arg(ccd).arg(chip).arg(binX).arg(binY);
+}
+
+void DarkLibrary::buildDarkIndex()
+{
+    darkIndex.clear();
+
+    for (const auto &map : darkFrames)
+        indexDarkFrame(map);
+}
+
+void DarkLibrary::indexDarkFrame(const QVariantMap &map)
+{
+    DarkFrameEntry entry;
+    entry.temperature = map["temperature"].toDouble();
+    entry.duration    = map["duration"].toDouble();
+    entry.timestamp   = QDateTime::fromString(map["timestamp"].toString(), Qt::ISODate);
+    entry.filename    = map["filename"].toString();
+
+    QVector<DarkFrameEntry> &entries = darkIndex[darkIndexKey(map["ccd"].toString(), map["chip"].toInt(),
+                                       map["binX"].toInt(), map["binY"].toInt())];
+
+    // Keep entries sorted by duration, and in database order for equal durations
+    auto position = std::upper_bound(entries.begin(), entries.end(), entry.duration,
+                                     [](double duration, const DarkFrameEntry & other)
     {
-        // First check CCD name matches and check if we are on the correct chip
-        if (map["ccd"].toString() == targetChip->getCCD()->getDeviceName() &&
-                map["chip"].toInt() == static_cast<int>(targetChip->getType()))
-        {
-            int binX, binY;
-            targetChip->getBinning(&binX, &binY);
+        return duration < other.duration;
+    });
+    entries.insert(position, entry);
+}
 
-            // Then check if binning is the same
-            if (map["binX"].toInt() == binX && map["binY"].toInt() == binY)
-            {
-                // Then check for temperature
-                if (targetChip->getCCD()->hasCooler())
-                {
-                    double temperature = 0;
-                    targetChip->getCCD()->getTemperature(&temperature);
-                    // TODO make this configurable value, the threshold
-                    if (fabs(map["temperature"].toDouble() - temperature) > Options::maxDarkTemperatureDiff())
-                        continue;
-                }
-
-                // Then check for duration
-                // TODO make this value configurable
-                if (fabs(map["duration"].toDouble() - duration) > 0.05)
-                    continue;
-
-                // Finally check if the duration is acceptable
-                QDateTime frameTime = QDateTime::fromString(map["timestamp"].toString(), Qt::ISODate);
-                if (frameTime.daysTo(QDateTime::currentDateTime()) > Options::darkLibraryDuration())
-                    continue;
-
-                QString filename = map["filename"].toString();
-
-                if (darkFiles.contains(filename))
-                    return darkFiles[filename];
-
-                // Finally we made it, let's put it in the hash
-                if (loadDarkFile(filename))
-                    return darkFiles[filename];
-                else
-                {
-                    // Remove bad dark frame
-                    emit newLog(i18n("Removing bad dark frame file %1", filename));
-                    darkFiles.remove(filename);
-                    QFile::remove(filename);
-                    KStarsData::Instance()->userdb()->DeleteDarkFrame(filename);
-                    return nullptr;
-                }
-            }
+QString DarkLibrary::findDarkFile(ISD::CCDChip *targetChip, double duration) const
+{
+    int binX, binY;
+    targetChip->getBinning(&binX, &binY);
+
+    auto entries = darkIndex.constFind(darkIndexKey(targetChip->getCCD()->getDeviceName(),
+                                       static_cast<int>(targetChip->getType()), binX, binY));
+    if (entries == darkIndex.constEnd())
+        return QString();
+
+    bool const hasCooler = targetChip->getCCD()->hasCooler();
+    double temperature = 0;
+    if (hasCooler)
+        targetChip->getCCD()->getTemperature(&temperature);
+
+    QDateTime const now = QDateTime::currentDateTime();
+
+    // TODO make this value configurable
+    double const durationThreshold = 0.05;
+
+    // Only dark frames within the duration threshold need to be checked
+    auto entry = std::lower_bound(entries->constBegin(), entries->constEnd(), duration - durationThreshold,
+                                  [](const DarkFrameEntry & other, double duration)
+    {
+        return other.duration < duration;
+    });
+
+    for (; entry != entries->constEnd() && entry->duration <= duration + durationThreshold; ++entry)
+    {
+        // Check for temperature
+        // TODO make this configurable value, the threshold
+        if (hasCooler && fabs(entry->temperature - temperature) > Options::maxDarkTemperatureDiff())
+            continue;
+
+        // Check if the age of the dark frame is acceptable
+        if (entry->timestamp.daysTo(now) > Options::darkLibraryDuration())
+            continue;
+
+        return entry->filename;
+    }
+
+    return QString();
+}
+
+void DarkLibrary::removeDarkFile(const QString &filename)
+{
+    emit newLog(i18n("Removing bad dark frame file %1", filename));
+
+    for (auto &entries : darkIndex)
+    {
+        for (auto entry = entries.begin(); entry != entries.end();)
+        {
+            if (entry->filename == filename)
+                entry = entries.erase(entry);
+            else
+                ++entry;
         }
     }
 
+    for (auto map = darkFrames.begin(); map != darkFrames.end();)
+    {
+        if ((*map)["filename"].toString() == filename)
+            map = darkFrames.erase(map);
+        else
+            ++map;
+    }
+
+    QFile::remove(filename);
+    KStarsData::Instance()->userdb()->DeleteDarkFrame(filename);
+}
+
+FITSData *DarkLibrary::getDarkFrame(ISD::CCDChip *targetChip, double duration)
+{
+    QString const filename = findDarkFile(targetChip, duration);
+
+    if (filename.isEmpty())
+        return nullptr;
+
+    if (darkFiles.contains(filename))
+    {
+        darkFilesUsage.removeOne(filename);
+        darkFilesUsage.append(filename);
+        return darkFiles[filename];
+    }
+
+    // Finally we made it, let's put it in the cache, waiting for the preload if one is running
+    if (darkPreloads.contains(filename) ? completePreload(filename) : loadDarkFile(filename))
+        return darkFiles[filename];
+
+    // Remove bad dark frame
+    removeDarkFile(filename);
     return nullptr;
 }
 
+void DarkLibrary::preloadDarkFrame(ISD::CCDChip *targetChip, double duration)
+{
+    QString const filename = findDarkFile(targetChip, duration);
+
+    if (filename.isEmpty() || darkFiles.contains(filename) || darkPreloads.contains(filename))
+        return;
+
+    FITSData *darkData = new FITSData();
+    darkPreloads[filename] = qMakePair(darkData, darkData->loadFITS(filename));
+
+    // Put the dark frame in the cache as soon as it is loaded, unless the light frame asked for it first
+    QFutureWatcher<bool> *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, filename]()
+    {
+        watcher->deleteLater();
+        if (darkPreloads.contains(filename) && !completePreload(filename))
+            removeDarkFile(filename);
+    });
+    watcher->setFuture(darkPreloads[filename].second);
+}
+
+bool DarkLibrary::completePreload(const QString &filename)
+{
+    QPair<FITSData *, QFuture<bool>> preload = darkPreloads.take(filename);
+
+    if (!preload.second.result())
+    {
+        emit newLog(i18n("Failed to load dark frame file %1", filename));
+        delete preload.first;
+        return false;
+    }
+
+    cacheDarkFile(filename, preload.first);
+    return true;
+}
+
 bool DarkLibrary::loadDarkFile(const QString &filename)
 {
     FITSData *darkData = new FITSData();
@@ -122,7 +400,7 @@ bool DarkLibrary::loadDarkFile(const QString &filename)
     bool rc = darkData->loadFITS(filename);
 
     if (rc)
-        darkFiles[filename] = darkData;
+        cacheDarkFile(filename, darkData);
     else
     {
         emit newLog(i18n("Failed to load dark frame file %1", filename));
@@ -132,6 +410,70 @@ bool DarkLibrary::loadDarkFile(const QString &filename)
     return rc;
 }
 
+void DarkLibrary::cacheDarkFile(const QString &filename, FITSData *darkData)
+{
+    if (darkFiles.contains(filename))
+    {
+        FITSData *oldData = darkFiles[filename];
+        darkFilesSize -= static_cast<qint64>(oldData->width()) * oldData->height() * oldData->channels() *
+                         oldData->getBytesPerPixel();
+        darkFilesUsage.removeOne(filename);
+        if (darkFilesInUse.contains(oldData))
+            darkFilesPendingDelete.insert(oldData);
+        else
+            delete oldData;
+    }
+
+    darkFiles[filename] = darkData;
+    darkFilesUsage.append(filename);
+    darkFilesSize += static_cast<qint64>(darkData->width()) * darkData->height() * darkData->channels() *
+                     darkData->getBytesPerPixel();
+
+    trimDarkFiles();
+}
+
+void DarkLibrary::trimDarkFiles()
+{
+    qint64 const maxSize = static_cast<qint64>(Options::darkLibraryCacheSize()) * 1024 * 1024;
+
+    // Always keep the most recently used dark frame, whatever its size
+    for (int i = 0; darkFilesSize > maxSize && i < darkFilesUsage.size() - 1;)
+    {
+        QString const filename = darkFilesUsage[i];
+        FITSData *darkData = darkFiles[filename];
+
+        if (darkFilesInUse.contains(darkData))
+        {
+            i++;
+            continue;
+        }
+
+        darkFilesSize -= static_cast<qint64>(darkData->width()) * darkData->height() * darkData->channels() *
+                         darkData->getBytesPerPixel();
+        darkFilesUsage.removeAt(i);
+        darkFiles.remove(filename);
+        delete darkData;
+    }
+}
+
+void DarkLibrary::pinDarkFile(FITSData *darkData)
+{
+    darkFilesInUse[darkData]++;
+}
+
+void DarkLibrary::unpinDarkFile(FITSData *darkData)
+{
+    if (--darkFilesInUse[darkData] > 0)
+        return;
+
+    darkFilesInUse.remove(darkData);
+
+    if (darkFilesPendingDelete.remove(darkData))
+        delete darkData;
+    else
+        trimDarkFiles();
+}
+
 bool DarkLibrary::saveDarkFile(FITSData *darkData)
 {
     // IS8601 contains colons but they are illegal under Windows OS, so replacing them with '-'
@@ -146,7 +488,7 @@ bool DarkLibrary::saveDarkFile(FITSData *darkData)
         return false;
     }
 
-    darkFiles[path] = darkData;
+    cacheDarkFile(path, darkData);
 
     QVariantMap map;
     int binX, binY;
@@ -162,8 +504,10 @@ bool DarkLibrary::saveDarkFile(FITSData *darkData)
     map["temperature"] = temperature;
     map["duration"]    = subtractParams.duration;
     map["filename"]    = path;
+    map["timestamp"]   = QDateTime::currentDateTime().toString(Qt::ISODate);
 
     darkFrames.append(map);
+    indexDarkFrame(map);
 
     emit newLog(i18n("Dark frame saved to %1", path));
 
@@ -271,10 +615,12 @@ void DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale f
     {
         checkTelescopeCover();
 
-        // Otherwise, call this function again
+        // Otherwise, call this function again, keeping the dark frame in the cache until then
+        pinDarkFile(darkData);
         QTimer::singleShot(1000, this, [this, darkData, lightImage, filter, offsetX, offsetY]
         {
             subtract(darkData, lightImage, filter, offsetX, offsetY);
+            unpinDarkFile(darkData);
         });
 
         return;
@@ -282,51 +628,50 @@ void DarkLibrary::subtract(FITSData *darkData, FITSView *lightImage, FITSScale f
 
     FITSData *lightData = lightImage->getImageData();
 
-    T *lightBuffer = reinterpret_cast<T *>(lightData->getWritableImageBuffer());
-    int lightW      = lightData->width();
-    int lightH      = lightData->height();
+    FITSData::Statistic lightStats;
+    lightData->saveStatistics(lightStats);
+
+    // The view deletes its data as soon as another frame arrives, so the first channel of the light is
+    // calibrated in a buffer owned by the job, and copied back on the GUI thread if still displayed.
+    size_t const lightSize = lightStats.samples_per_channel;
+    T const *lightBuffer   = reinterpret_cast<T const *>(lightData->getImageBuffer());
+    std::shared_ptr<std::vector<T>> calibrated(new std::vector<T>(lightBuffer, lightBuffer + lightSize));
 
     int darkW      = darkData->width();
     int darkoffset = offsetX + offsetY * darkW;
     T const *darkBuffer  = reinterpret_cast<T const*>(darkData->getImageBuffer()) + darkoffset;
 
-    for (int i = 0; i < lightH; i++)
+    // Calibrate off the GUI thread, computing the statistics of the result in the same pass.
+    // The dark frame cannot be evicted from the cache meanwhile.
+    QPointer<FITSView> view(lightImage);
+    QPointer<FITSData> light(lightData);
+    pinDarkFile(darkData);
+    QFutureWatcher<FITSData::Statistic> *watcher = new QFutureWatcher<FITSData::Statistic>(this);
+    connect(watcher, &QFutureWatcher<FITSData::Statistic>::finished, this, [this, watcher, view, darkData, light, calibrated,
+                                                                         filter]()
     {
-        for (int j = 0; j < lightW; j++)
-            lightBuffer[j] = (lightBuffer[j] > darkBuffer[j]) ? (lightBuffer[j] - darkBuffer[j]) : 0;
+        watcher->deleteLater();
 
-        lightBuffer += lightW;
-        darkBuffer += darkW;
-    }
+        unpinDarkFile(darkData);
 
-#if 0
-    int lightOffset = 0;
-    for (int i = 0; i < lightH; i++)
-    {
-        for (int j = 0; j < lightW; j++)
-        {
-            if (lightBuffer[j + lightOffset] > darkBuffer[j + darkoffset])
-                lightBuffer[j + lightOffset] -= darkBuffer[j + darkoffset];
-            else
-                lightBuffer[j + lightOffset] = 0;
-        }
+        // The light was replaced, and possibly deleted, while it was calibrated.
+        // The newer frame has its own subtraction, so the stale result is dropped silently.
+        if (view.isNull() || light.isNull() || view->getImageData() != light)
+            return;
 
-        lightOffset += lightW;
-        darkoffset += darkW;
-    }
-#endif
+        std::copy(calibrated->begin(), calibrated->end(), reinterpret_cast<T *>(light->getWritableImageBuffer()));
+        light->refreshStatistics(watcher->result());
+        light->applyFilter(filter);
+        view->rescale(ZOOM_KEEP_LEVEL);
+        view->updateFrame();
 
-    lightData->applyFilter(filter);
-    //if (Options::autoStretch())
-    //    lightData->applyFilter(FITS_AUTO_STRETCH);
-    //else if (filter == FITS_NONE)
-    //    lightData->calculateStats(true);
-    if (filter == FITS_NONE)
-        lightData->calculateStats(true);
-    lightImage->rescale(ZOOM_KEEP_LEVEL);
-    lightImage->updateFrame();
-
-    emit darkFrameCompleted(true);
+        emit darkFrameCompleted(true);
+    });
+
+    watcher->setFuture(QtConcurrent::run([lightStats, calibrated, darkBuffer, darkW]()
+    {
+        return subtractDark<T>(lightStats, calibrated->data(), darkBuffer, darkW);
+    }));
 }
 
 void DarkLibrary::captureAndSubtract(ISD::CCDChip *targetChip, FITSView *targetImage, double duration, uint16_t offsetX,
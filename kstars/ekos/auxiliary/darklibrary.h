@@ -12,7 +12,10 @@
 #include "indi/indiccd.h"
 #include "indi/indicap.h"
 
+#include <QDateTime>
+#include <QFuture>
 #include <QObject>
+#include <QSet>
 
 namespace Ekos
 {
@@ -32,6 +35,13 @@ class DarkLibrary : public QObject
         static DarkLibrary *Instance();
 
         FITSData *getDarkFrame(ISD::CCDChip *targetChip, double duration);
+        /**
+         * @brief preloadDarkFrame Load the dark frame matching the current settings of a chip in the background,
+         * so that it is ready when the light frame being captured arrives.
+         * @param targetChip chip about to capture, with its binning and temperature already set.
+         * @param duration exposure duration in seconds.
+         */
+        void preloadDarkFrame(ISD::CCDChip *targetChip, double duration);
         void subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY);
         // Return false if canceled. True if dark capture proceeds
         void captureAndSubtract(ISD::CCDChip *targetChip, FITSView *targetImage, double duration, uint16_t offsetX,
@@ -66,8 +76,53 @@ class DarkLibrary : public QObject
         template <typename T>
         void subtract(FITSData *darkData, FITSView *lightImage, FITSScale filter, uint16_t offsetX, uint16_t offsetY);
 
+        /// Dark frame of the user database, with the fields used for matching parsed once
+        typedef struct
+        {
+            double temperature;
+            double duration;
+            QDateTime timestamp;
+            QString filename;
+        } DarkFrameEntry;
+
+        /// Index key of dark frames taken with a given camera, chip and binning
+        static QString darkIndexKey(const QString &ccd, int chip, int binX, int binY);
+        /// Rebuild the dark frame index from the list of dark frames
+        void buildDarkIndex();
+        /// Add a dark frame of the database to the index
+        void indexDarkFrame(const QVariantMap &map);
+        /// Find the file of the dark frame matching the current settings of a chip, or an empty string
+        QString findDarkFile(ISD::CCDChip *targetChip, double duration) const;
+        /// Remove a dark frame that could not be loaded from the disk, the index and the database
+        void removeDarkFile(const QString &filename);
+
+        /// Insert a loaded dark frame in the cache, evicting the least recently used ones over the size limit
+        void cacheDarkFile(const QString &filename, FITSData *darkData);
+        /// Wait for a background load of a dark frame, and cache its result
+        bool completePreload(const QString &filename);
+        /// Delete least recently used dark frames until the cache fits in its size limit
+        void trimDarkFiles();
+        /// Keep a dark frame in memory while it is subtracted
+        void pinDarkFile(FITSData *darkData);
+        /// Release a dark frame once subtracted, deleting it if it left the cache meanwhile
+        void unpinDarkFile(FITSData *darkData);
+
         QList<QVariantMap> darkFrames;
+        /// Dark frames by camera, chip and binning, sorted by duration
+        QHash<QString, QVector<DarkFrameEntry>> darkIndex;
+
+        /// Dark frames in memory by file name
         QHash<QString, FITSData *> darkFiles;
+        /// File names of the dark frames in memory, least recently used first
+        QStringList darkFilesUsage;
+        /// Memory used by the dark frames in memory, in bytes
+        qint64 darkFilesSize { 0 };
+        /// Dark frames being subtracted, which cannot be evicted from the cache until done
+        QHash<FITSData const *, int> darkFilesInUse;
+        /// Dark frames replaced in the cache while being subtracted, deleted once released
+        QSet<FITSData *> darkFilesPendingDelete;
+        /// Dark frames being loaded in the background by file name
+        QHash<QString, QPair<FITSData *, QFuture<bool>>> darkPreloads;
 
         struct
         {
@@ -2147,6 +2147,9 @@ void Capture::captureImage()
             appendLogText(i18n("Capturing %1-second %2 image...", QString("%L1").arg(activeJob->getExposure(), 0, 'f', 3),
                                activeJob->getFilterName()));
             captureTimeout.start(activeJob->getExposure() * 1000 + CAPTURE_TIMEOUT_THRESHOLD);
+            // Load the dark frame while the light frame is exposing
+            if (useGuideHead == false && darkSubCheck->isChecked() && activeJob->isPreview())
+                DarkLibrary::Instance()->preloadDarkFrame(activeJob->getActiveChip(), activeJob->getExposure());
             if (activeJob->isPreview() == false)
             {
                 int index = jobs.indexOf(activeJob);
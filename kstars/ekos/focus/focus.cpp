@@ -927,6 +927,10 @@ void Focus::capture()
 
     targetChip->capture(seqExpose);
 
+    // Load the dark frame while the light frame is exposing
+    if (darkFrameCheck->isChecked())
+        DarkLibrary::Instance()->preloadDarkFrame(targetChip, exposureIN->value());
+
     if (inFocusLoop == false)
     {
         appendLogText(i18n("Capturing image..."));
@@ -2961,7 +2965,8 @@ void Focus::syncTrackingBoxPosition()
 void Focus::showFITSViewer()
 {
     FITSData *data = focusView->getImageData();
-    if (data)
+    // Frames are kept in memory until the FITS Viewer needs their file
+    if (data && data->persistFile())
     {
         QUrl url = QUrl::fromLocalFile(data->filename());
 
@@ -1094,6 +1094,10 @@ bool Guide::captureOneFrame()
 
     targetChip->capture(finalExposure);
 
+    // Load the dark frame while the light frame is exposing
+    if (Options::guideDarkFrameEnabled())
+        DarkLibrary::Instance()->preloadDarkFrame(targetChip, exposureIN->value());
+
     return true;
 }
 
@@ -3013,7 +3017,8 @@ void Guide::processGuideOptions()
 void Guide::showFITSViewer()
 {
     FITSData *data = guideView->getImageData();
-    if (data)
+    // Frames are kept in memory until the FITS Viewer needs their file
+    if (data && data->persistFile())
     {
         QUrl url = QUrl::fromLocalFile(data->filename());
 
@@ -564,95 +564,14 @@ void cgmath::setLostStar(bool is_lost)
     lost_star = is_lost;
 }
 
-float *cgmath::createFloatImage(FITSData *target) const
+FITSFloatBuffer cgmath::createFloatImage(FITSData *target) const
 {
     FITSData *imageData = target;
     if (imageData == nullptr)
         imageData = guideView->getImageData();
 
-    // #1 Convert to float array
     // We only process 1st plane if it is a color image
-    uint32_t imgSize = imageData->width() * imageData->height();
-    float *imgFloat  = new float[imgSize];
-
-    if (imgFloat == nullptr)
-    {
-        qCritical() << "Not enough memory for float image array!";
-        return nullptr;
-    }
-
-    switch (imageData->property("dataType").toInt())
-    {
-        case TBYTE:
-        {
-            uint8_t const *buffer = imageData->getImageBuffer();
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TSHORT:
-        {
-            int16_t const *buffer = reinterpret_cast<int16_t const *>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TUSHORT:
-        {
-            uint16_t const *buffer = reinterpret_cast<uint16_t const*>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TLONG:
-        {
-            int32_t const *buffer = reinterpret_cast<int32_t const*>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TULONG:
-        {
-            uint32_t const *buffer = reinterpret_cast<uint32_t const*>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TFLOAT:
-        {
-            float const *buffer = reinterpret_cast<float const*>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TLONGLONG:
-        {
-            int64_t const *buffer = reinterpret_cast<int64_t const*>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        case TDOUBLE:
-        {
-            double const *buffer = reinterpret_cast<double const*>(imageData->getImageBuffer());
-            for (uint32_t i = 0; i < imgSize; i++)
-                imgFloat[i] = buffer[i];
-        }
-        break;
-
-        default:
-            delete[] imgFloat;
-            return nullptr;
-    }
-
-    return imgFloat;
+    return FITSConversion::toFloat(imageData);
 }
 
 QVector<float *> cgmath::partitionImage() const
@@ -661,9 +580,7 @@ QVector<float *> cgmath::partitionImage() const
 
     FITSData *imageData = guideView->getImageData();
 
-    float *imgFloat = createFloatImage();
-
-    if (imgFloat == nullptr)
+    if (!FITSConversion::isSupported(imageData->property("dataType").toInt()))
         return regions;
 
     const uint16_t width  = imageData->width();
@@ -674,35 +591,18 @@ QVector<float *> cgmath::partitionImage() const
     // Find number of regions to divide the image
     //uint8_t regions =  xRegions * yRegions;
 
-    float *regionPtr = imgFloat;
-
+    // Each region is converted to float from the image data, without converting the whole image first
     for (uint8_t i = 0; i < yRegions; i++)
     {
         for (uint8_t j = 0; j < xRegions; j++)
         {
             // Allocate space for one region
             float *oneRegion = new float[regionAxis * regionAxis];
-            // Create points to region and current location of the source image in the desired region
-            float *oneRegionPtr = oneRegion, *imgFloatPtr = regionPtr + j * regionAxis;
-
-            // copy from image to region line by line
-            for (uint32_t line = 0; line < regionAxis; line++)
-            {
-                memcpy(oneRegionPtr, imgFloatPtr, regionAxis);
-                oneRegionPtr += regionAxis;
-                imgFloatPtr += width;
-            }
-
+            FITSConversion::toFloat(imageData, QRect(j * regionAxis, i * regionAxis, regionAxis, regionAxis), oneRegion);
             regions.append(oneRegion);
         }
-
-        // Move regionPtr block by (width * regionAxis) elements
-        regionPtr += width * regionAxis;
     }
 
-    // We're done with imgFloat
-    delete[] imgFloat;
-
     return regions;
 }
 
@@ -1583,18 +1483,19 @@ QList<Edge*> cgmath::PSFAutoFind(int extraEdgeAllowance)
     int size = subW * subH;
 
     // convert to floating point
-    float *conv = createFloatImage(smoothed);
-
-    // run the PSF convolution
+    FITSFloatBuffer image = createFloatImage(smoothed);
+    if (image.isNull())
     {
-        float *tmp = new float[size];
-        memset(tmp, 0, size * sizeof(float));
-        psf_conv(tmp, conv, subW, subH);
-        delete [] conv;
-        // Swap
-        conv = tmp;
+        delete (smoothed);
+        return QList<Edge*>();
     }
 
+    // run the PSF convolution
+    FITSFloatBuffer psf(size);
+    float *conv = psf.data();
+    memset(conv, 0, size * sizeof(float));
+    psf_conv(conv, image.data(), subW, subH);
+
     enum { CONV_RADIUS = 4 };
     int dw = subW;      // width of the downsampled image
     int dh = subH;     // height of the downsampled image
@@ -1761,7 +1662,6 @@ repeat:
         centers.append(center);
     }
 
-    delete [] conv;
     delete (smoothed);
 
     return centers;
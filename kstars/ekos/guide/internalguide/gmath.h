@@ -13,6 +13,7 @@
 
 #include "matr.h"
 #include "vect.h"
+#include "fitsviewer/fitsconversion.h"
 #include "indi/indicommon.h"
 
 #include <QObject>
@@ -180,8 +181,8 @@ class cgmath : public QObject
     template <typename T>
     Vector findLocalStarPosition(void) const;
 
-    // Creates a new float image from the guideView image data. The returned image MUST be deleted later or memory will leak.
-    float *createFloatImage(FITSData *target=nullptr) const;
+    // Converts the target image data, or the guideView image data, to float. The image is null if the data type is not supported.
+    FITSFloatBuffer createFloatImage(FITSData *target=nullptr) const;
 
     void do_ticks(void);
     Vector point2arcsec(const Vector &p) const;
@@ -31,6 +31,10 @@
 #include <KNotifications/KNotification>
 #include <KConfigDialog>
 
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
 #include <fitsio.h>
 #include <ekos_scheduler_debug.h>
 
@@ -1537,6 +1541,9 @@ void Scheduler::evaluateJobs()
     /* Update dawn and dusk astronomical times - unconditionally in case date changed */
     calculateDawnDusk();
 
+    /* Calculate what the evaluation will need concurrently, the sequential evaluation below then reads the job caches */
+    prefetchJobEvaluations(jobs, now);
+
     /* First, filter out non-schedulable jobs */
     /* FIXME: jobs in state JOB_ERROR should not be in the list, reorder states */
     QList<SchedulerJob *> sortedJobs = jobs;
@@ -2162,6 +2169,20 @@ void Scheduler::evaluateJobs()
         }
     }
 
+    /* Report how much of the evaluation was spared by the per-job caches */
+    uint32_t cacheHits = 0, cacheMisses = 0;
+    foreach (SchedulerJob *job, jobs)
+    {
+        cacheHits += job->getEvaluationCacheHits();
+        cacheMisses += job->getEvaluationCacheMisses();
+        job->clearEvaluationStatistics();
+    }
+    if (0 < cacheHits + cacheMisses)
+        qCInfo(KSTARS_EKOS_SCHEDULER) << QString("Job evaluation cache hit rate is %1% (%2 hits, %3 misses).")
+                                      .arg(100.0 * cacheHits / (cacheHits + cacheMisses), 0, 'f', 1)
+                                      .arg(cacheHits)
+                                      .arg(cacheMisses);
+
     /* Apply sorting to queue table, and mark it for saving if it changes */
     mDirty = reorderJobs(sortedJobs) | mDirty;
 
@@ -2237,6 +2258,60 @@ void Scheduler::evaluateJobs()
     setCurrentJob(job_to_execute);
 }
 
+void Scheduler::prefetchJobEvaluations(QList<SchedulerJob *> const &jobs, QDateTime const &when)
+{
+    QList<SchedulerJob *> prefetchedJobs;
+    for (SchedulerJob * const job : jobs)
+    {
+        switch (job->getState())
+        {
+            case SchedulerJob::JOB_INVALID:
+            case SchedulerJob::JOB_COMPLETE:
+            case SchedulerJob::JOB_BUSY:
+            case SchedulerJob::JOB_ERROR:
+                break;
+
+            default:
+                prefetchedJobs.append(job);
+                break;
+        }
+    }
+
+    int const threads = qMin(QThreadPool::globalInstance()->maxThreadCount(), prefetchedJobs.size());
+
+    /* Not worth it without parallelism, evaluation will calculate the same things anyway */
+    if (threads < 2)
+        return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    /* Contexts copy the Moon, they must be created and destroyed on this thread */
+    std::vector<std::unique_ptr<SchedulerJob::EphemerisContext>> contexts;
+    for (int i = 0; i < threads; i++)
+        contexts.emplace_back(new SchedulerJob::EphemerisContext());
+
+    /* Each thread takes every n-th job, jobs of a mosaic cost about the same */
+    QList<QFuture<void>> futures;
+    for (int i = 0; i < threads; i++)
+    {
+        SchedulerJob::EphemerisContext * const context = contexts[i].get();
+        futures.append(QtConcurrent::run([&prefetchedJobs, &when, context, i, threads]()
+        {
+            for (int j = i; j < prefetchedJobs.size(); j += threads)
+                prefetchedJobs[j]->prefetchEvaluation(when, *context);
+        }));
+    }
+
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    qCDebug(KSTARS_EKOS_SCHEDULER) << QString("Prefetched evaluation of %1 jobs on %2 threads in %3 ms.")
+                                   .arg(prefetchedJobs.size())
+                                   .arg(threads)
+                                   .arg(timer.elapsed());
+}
+
 void Scheduler::wakeUpScheduler()
 {
     sleepLabel->hide();
@@ -4697,6 +4772,9 @@ void Scheduler::setDirty()
         for (int row = jobUnderEdit; row < jobs.size(); row++)
             jobs.at(row)->reset();
 
+        // The edited job may get a new target or new constraints
+        jobs.at(jobUnderEdit)->clearEvaluationCache();
+
         saveJob();
     }
 
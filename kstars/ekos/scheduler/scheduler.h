@@ -491,6 +491,15 @@ class Scheduler : public QWidget, public Ui::Scheduler
              */
         void evaluateJobs();
 
+        /**
+             * @brief prefetchJobEvaluations Fill the evaluation caches of jobs concurrently on the global thread pool.
+             * @details evaluateJobs() is sequential, as jobs depend on each other and on the user interface, but the costly
+             * astronomical calculations it asks for can be done beforehand, each thread with its own ephemeris context.
+             * @param jobs jobs to prefetch, those which cannot be scheduled are skipped.
+             * @param when date and time of the evaluation.
+             */
+        void prefetchJobEvaluations(QList<SchedulerJob *> const &jobs, QDateTime const &when);
+
         /**
              * @brief executeJob After the best job is selected, we call this in order to start the process that will execute the job.
              * checkJobStatus slot will be connected in order to figure the exact state of the current job each second
@@ -26,7 +26,9 @@
 
 SchedulerJob::SchedulerJob()
 {
-    moon = dynamic_cast<KSMoon *>(KStarsData::Instance()->skyComposite()->findByName(i18n("Moon")));
+    KSMoon const * const globalMoon = dynamic_cast<KSMoon *>(KStarsData::Instance()->skyComposite()->findByName(i18n("Moon")));
+    if (globalMoon)
+        moon.reset(globalMoon->clone());
 }
 
 void SchedulerJob::setName(const QString &value)
@@ -77,11 +79,13 @@ void SchedulerJob::setFITSFile(const QUrl &value)
 void SchedulerJob::setMinAltitude(const double &value)
 {
     minAltitude = value;
+    clearEvaluationCache();
 }
 
 void SchedulerJob::setMinMoonSeparation(const double &value)
 {
     minMoonSeparation = value;
+    clearEvaluationCache();
 }
 
 void SchedulerJob::setEnforceWeather(bool value)
@@ -202,6 +206,7 @@ void SchedulerJob::setScore(int value)
 void SchedulerJob::setCulminationOffset(const int16_t &value)
 {
     culminationOffset = value;
+    clearEvaluationCache();
 }
 
 void SchedulerJob::setSequenceCount(const int count)
@@ -422,6 +427,8 @@ void SchedulerJob::setTargetCoords(dms &ra, dms &dec)
     targetCoords.setDec0(dec);
 
     targetCoords.apparentCoord(static_cast<long double>(J2000), KStarsData::Instance()->ut().djd());
+
+    clearEvaluationCache();
 }
 
 void SchedulerJob::updateJobCells()
@@ -678,9 +685,126 @@ void SchedulerJob::reset()
     startupTime = fileStartupCondition == START_AT ? fileStartupTime : QDateTime();
     /* No change to culmination offset */
     repeatsRemaining = repeatsRequired;
+    /* No change to evaluation cache, target and constraints are unchanged */
     updateJobCells();
 }
 
+void SchedulerJob::clearEvaluationCache()
+{
+    evaluationCache.altitudeScores.clear();
+    evaluationCache.moonSeparationScores.clear();
+    evaluationCache.altitudeTimes.clear();
+    evaluationCache.culminationTimes.clear();
+}
+
+void SchedulerJob::clearEvaluationStatistics()
+{
+    evaluationCache.hits   = 0;
+    evaluationCache.misses = 0;
+}
+
+SchedulerJob::EphemerisContext::EphemerisContext() :
+    geo(*KStarsData::Instance()->geo()),
+    lt(KStarsData::Instance()->lt()),
+    settingAltitudeCutoff(Options::settingAltitudeCutoff()),
+    leadTime(Options::leadTime())
+{
+    KSMoon const * const globalMoon = dynamic_cast<KSMoon *>(KStarsData::Instance()->skyComposite()->findByName(i18n("Moon")));
+    if (globalMoon)
+    {
+        moon.reset(globalMoon->clone());
+        // Lunar series are loaded once and shared, make sure no evaluating thread has to load them
+        moon->loadData();
+    }
+}
+
+void SchedulerJob::prefetchEvaluation(QDateTime const &when, EphemerisContext &context)
+{
+    ephemerisContext = &context;
+
+    QList<QDateTime> times = { when };
+    if (startupTime.isValid() && startupTime != when)
+        times.append(startupTime);
+
+    for (QDateTime const &t : times)
+    {
+        getAltitudeScore(t);
+        getMoonSeparationScore(t);
+        if (-90 < getMinAltitude())
+            calculateAltitudeTime(t);
+        if (START_CULMINATION == startupCondition)
+            calculateCulmination(t);
+    }
+
+    ephemerisContext = nullptr;
+}
+
+GeoLocation *SchedulerJob::getGeo() const
+{
+    return ephemerisContext ? &ephemerisContext->geo : KStarsData::Instance()->geo();
+}
+
+KStarsDateTime SchedulerJob::getLocalTime() const
+{
+    return ephemerisContext ? ephemerisContext->lt : KStarsData::Instance()->lt();
+}
+
+KSMoon *SchedulerJob::getMoon() const
+{
+    return ephemerisContext ? ephemerisContext->moon.get() : moon.get();
+}
+
+double SchedulerJob::getSettingAltitudeCutoff() const
+{
+    return ephemerisContext ? ephemerisContext->settingAltitudeCutoff : Options::settingAltitudeCutoff();
+}
+
+double SchedulerJob::getLeadTimeOption() const
+{
+    return ephemerisContext ? ephemerisContext->leadTime : Options::leadTime();
+}
+
+template <typename T, typename F>
+T SchedulerJob::cachedEvaluation(QHash<qint64, T> &cache, QDateTime const &when, int bucket, F evaluate) const
+{
+    // Results depend on the geolocation and options too, drop them all if any of those changed
+    GeoLocation const * const geo = getGeo();
+    double const settingAltitudeCutoff = getSettingAltitudeCutoff();
+    double const leadTime = getLeadTimeOption();
+    if (evaluationCache.latitude != geo->lat()->Degrees() || evaluationCache.longitude != geo->lng()->Degrees() ||
+            evaluationCache.timeZone != geo->TZ() || evaluationCache.settingAltitudeCutoff != settingAltitudeCutoff ||
+            evaluationCache.leadTime != leadTime)
+    {
+        clearEvaluationCache();
+        evaluationCache.latitude = geo->lat()->Degrees();
+        evaluationCache.longitude = geo->lng()->Degrees();
+        evaluationCache.timeZone = geo->TZ();
+        evaluationCache.settingAltitudeCutoff = settingAltitudeCutoff;
+        evaluationCache.leadTime = leadTime;
+    }
+
+    // Key on the time bucket, keeping local and universal times apart as the evaluations interpret them differently
+    QDateTime const t = when.isValid() ? when : static_cast<QDateTime>(getLocalTime());
+    qint64 const seconds = t.date().toJulianDay() * 24 * 60 * 60 + t.time().msecsSinceStartOfDay() / 1000;
+    qint64 const key = (seconds / bucket) * 2 + (Qt::UTC == t.timeSpec() ? 1 : 0);
+
+    auto const it = cache.constFind(key);
+    if (it != cache.constEnd())
+    {
+        evaluationCache.hits++;
+        return it.value();
+    }
+
+    evaluationCache.misses++;
+    T const result = evaluate(when);
+
+    // Keep the cache bounded, as evaluations for the current time leave a trail of stale entries
+    if (1024 <= cache.size())
+        cache.clear();
+    cache.insert(key, result);
+    return result;
+}
+
 bool SchedulerJob::decreasingScoreOrder(SchedulerJob const *job1, SchedulerJob const *job2)
 {
     return job1->getScore() > job2->getScore();
@@ -719,14 +843,22 @@ bool SchedulerJob::increasingStartupTimeOrder(SchedulerJob const *job1, Schedule
 }
 
 int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
+{
+    return cachedEvaluation(evaluationCache.altitudeScores, when, 60, [this](QDateTime const &t)
+    {
+        return evaluateAltitudeScore(t);
+    });
+}
+
+int16_t SchedulerJob::evaluateAltitudeScore(QDateTime const &when) const
 {
     // FIXME: block calculating target coordinates at a particular time is duplicated in several places
-    GeoLocation *geo = KStarsData::Instance()->geo();
+    GeoLocation *geo = getGeo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
     KStarsDateTime ltWhen(when.isValid() ?
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
-                          KStarsData::Instance()->lt());
+                          getLocalTime());
 
     // Create a sky object with the target catalog coordinates
     SkyPoint const target = getTargetCoords();
@@ -743,7 +875,7 @@ int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
     o.EquatorialToHorizontal(&LST, geo->lat());
     double const altitude = o.alt().Degrees();
 
-    double const SETTING_ALTITUDE_CUTOFF = Options::settingAltitudeCutoff();
+    double const SETTING_ALTITUDE_CUTOFF = getSettingAltitudeCutoff();
     int16_t score = BAD_SCORE - 1;
 
     // If altitude is negative, bad score
@@ -791,14 +923,22 @@ int16_t SchedulerJob::getAltitudeScore(QDateTime const &when) const
 }
 
 int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
+{
+    return cachedEvaluation(evaluationCache.moonSeparationScores, when, 60, [this](QDateTime const &t)
+    {
+        return evaluateMoonSeparationScore(t);
+    });
+}
+
+int16_t SchedulerJob::evaluateMoonSeparationScore(QDateTime const &when) const
 {
     // FIXME: block calculating target coordinates at a particular time is duplicated in several places
-    GeoLocation *geo = KStarsData::Instance()->geo();
+    GeoLocation *geo = getGeo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
     KStarsDateTime ltWhen(when.isValid() ?
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
-                          KStarsData::Instance()->lt());
+                          getLocalTime());
 
     // Create a sky object with the target catalog coordinates
     SkyPoint const target = getTargetCoords();
@@ -815,20 +955,23 @@ int16_t SchedulerJob::getMoonSeparationScore(QDateTime const &when) const
     //KSNumbers ksnum(ut.djd()); // BUG: possibly LT.djd() != UT.djd() because of translation
     //LST = geo->GSTtoLST(ut.gst());
     CachingDms LST = geo->GSTtoLST(geo->LTtoUT(ltWhen).gst());
-    moon->updateCoords(&numbers, true, geo->lat(), &LST, true);
+    KSMoon * const evaluationMoon = getMoon();
+    evaluationMoon->findLocalPosition(&numbers, geo->lat(), &LST);
 
-    double const moonAltitude = moon->alt().Degrees();
-
-    // Lunar illumination %
-    double const illum = moon->illum() * 100.0;
+    // Compute target altitude for the zenith distance
+    o.EquatorialToHorizontal(&LST, geo->lat());
 
-    // Moon/Sky separation p
-    double const separation = moon->angularDistanceTo(&o).Degrees();
+    return calculateMoonSeparationScore(evaluationMoon->angularDistanceTo(&o).Degrees(), evaluationMoon->alt().Degrees(),
+                                        o.alt().Degrees(), evaluationMoon->illum() * 100.0);
+}
 
+int16_t SchedulerJob::calculateMoonSeparationScore(double separation, double moonAltitude, double targetAltitude,
+        double illum) const
+{
     // Zenith distance of the moon
     double const zMoon = (90 - moonAltitude);
     // Zenith distance of target
-    double const zTarget = (90 - o.alt().Degrees());
+    double const zTarget = (90 - targetAltitude);
 
     int16_t score = 0;
 
@@ -889,21 +1032,27 @@ double SchedulerJob::getCurrentMoonSeparation() const
     //KSNumbers ksnum(ut.djd()); // BUG: possibly LT.djd() != UT.djd() because of translation
     //LST = geo->GSTtoLST(ut.gst());
     CachingDms LST = geo->GSTtoLST(geo->LTtoUT(ltWhen).gst());
-    moon->updateCoords(&numbers, true, geo->lat(), &LST, true);
+    moon->findLocalPosition(&numbers, geo->lat(), &LST);
 
     // Moon/Sky separation p
     return moon->angularDistanceTo(&o).Degrees();
 }
 
-QDateTime SchedulerJob::calculateAltitudeTime(QDateTime const &when) const
+QVector<SchedulerJob::AltitudeSample> SchedulerJob::calculateAltitudes(QDateTime const &when, int step, int count,
+        bool withMoon) const
 {
+    QVector<AltitudeSample> samples;
+    if (step <= 0 || count <= 0)
+        return samples;
+    samples.reserve(count);
+
     // FIXME: block calculating target coordinates at a particular time is duplicated in several places
-    GeoLocation *geo = KStarsData::Instance()->geo();
+    GeoLocation *geo = getGeo();
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
     KStarsDateTime ltWhen(when.isValid() ?
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
-                          KStarsData::Instance()->lt());
+                          getLocalTime());
 
     // Create a sky object with the target catalog coordinates
     SkyPoint const target = getTargetCoords();
@@ -911,60 +1060,166 @@ QDateTime SchedulerJob::calculateAltitudeTime(QDateTime const &when) const
     o.setRA0(target.ra0());
     o.setDec0(target.dec0());
 
-    // Calculate the UT at the argument time
-    KStarsDateTime const ut = geo->LTtoUT(ltWhen);
+    // Nutation, precession and aberration terms are fully calculated at most a day apart, and interpolated in between
+    int const anchorSamples = qMax(1, 24 * 60 * 60 / step);
+    KSMoon * const evaluationMoon = getMoon();
+    KSNumbers from(ltWhen.djd());
+    KSNumbers to(from);
+    KSNumbers numbers(from);
 
-    double const SETTING_ALTITUDE_CUTOFF = Options::settingAltitudeCutoff();
-
-    // Within the next 24 hours, search when the job target matches the altitude and moon constraints
-    for (unsigned int minute = 0; minute < 24 * 60; minute++)
+    for (int i = 0; i < count; i++)
     {
-        KStarsDateTime const ltOffset(ltWhen.addSecs(minute * 60));
+        KStarsDateTime const ltOffset(ltWhen.addSecs(static_cast<double>(i) * step));
+
+        if (i % anchorSamples == 0)
+        {
+            // The previous interval ends exactly on this sample
+            if (0 < i)
+                from = to;
+            int const last = qMin(i + anchorSamples, count - 1);
+            to.updateValues(ltWhen.addSecs(static_cast<double>(last) * step).djd());
+        }
 
         // Update RA/DEC of the target for the current fraction of the day
-        KSNumbers numbers(ltOffset.djd());
+        numbers.interpolateValues(ltOffset.djd(), from, to);
         o.updateCoordsNow(&numbers);
 
         // Compute local sidereal time for the current fraction of the day, calculate altitude
         CachingDms const LST = geo->GSTtoLST(geo->LTtoUT(ltOffset).gst());
         o.EquatorialToHorizontal(&LST, geo->lat());
-        double const altitude = o.alt().Degrees();
 
-        if (getMinAltitude() <= altitude)
+        AltitudeSample sample;
+        sample.when     = ltOffset;
+        sample.altitude = o.alt().Degrees();
+
+        // Hours are reduced to [0,24[, meridian being at 0
+        double offset = LST.Hours() - o.ra().Hours();
+        if (24.0 <= offset)
+            offset -= 24.0;
+        else if (offset < 0.0)
+            offset += 24.0;
+        sample.isSetting = 0.0 <= offset && offset < 12.0;
+
+        // The Moon is as costly to update as the numbers, so only do it where the result may matter
+        if (withMoon && getMinAltitude() <= sample.altitude)
         {
-            // Don't test proximity to dawn in this situation, we only cater for altitude here
+            evaluationMoon->findLocalPosition(&numbers, geo->lat(), &LST);
+            sample.moonSeparation      = evaluationMoon->angularDistanceTo(&o).Degrees();
+            sample.moonSeparationScore = calculateMoonSeparationScore(sample.moonSeparation, evaluationMoon->alt().Degrees(),
+                                         sample.altitude, evaluationMoon->illum() * 100.0);
+        }
 
-            // Continue searching if Moon separation is not good enough
-            if (0 < getMinMoonSeparation() && getMoonSeparationScore(ltOffset) < 0)
-                continue;
+        samples.append(sample);
+    }
 
-            // Continue searching if target is setting and under the cutoff
-            double offset = LST.Hours() - o.ra().Hours();
-            if (24.0 <= offset)
-                offset -= 24.0;
-            else if (offset < 0.0)
-                offset += 24.0;
-            if (0.0 <= offset && offset < 12.0)
-                if (altitude - SETTING_ALTITUDE_CUTOFF < getMinAltitude())
-                    continue;
+    return samples;
+}
+
+QDateTime SchedulerJob::calculateAltitudeTime(QDateTime const &when) const
+{
+    return cachedEvaluation(evaluationCache.altitudeTimes, when, 1, [this](QDateTime const &t)
+    {
+        return evaluateAltitudeTime(t);
+    });
+}
+
+QDateTime SchedulerJob::evaluateAltitudeTime(QDateTime const &when) const
+{
+    // FIXME: block calculating target coordinates at a particular time is duplicated in several places
+    GeoLocation *geo = getGeo();
+
+    // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
+    KStarsDateTime ltWhen(when.isValid() ?
+                          Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
+                          getLocalTime());
+
+    // Create a sky object with the target catalog coordinates
+    SkyPoint const target = getTargetCoords();
+    SkyObject o;
+    o.setRA0(target.ra0());
+    o.setDec0(target.dec0());
 
-            return ltOffset;
+    // Update RA/DEC for the argument date/time
+    KSNumbers numbers(ltWhen.djd());
+    o.updateCoordsNow(&numbers);
+
+    double const SETTING_ALTITUDE_CUTOFF = getSettingAltitudeCutoff();
+
+    // The target must be above the minimum altitude, and above the cutoff too once it passed the meridian
+    auto const isAltitudeOK = [&](double altitude, bool isSetting)
+    {
+        return getMinAltitude() <= altitude && !(isSetting && altitude - SETTING_ALTITUDE_CUTOFF < getMinAltitude());
+    };
+
+    // Within the next 24 hours, search when the job target matches the altitude constraint
+    KStarsDateTime const ut = geo->LTtoUT(ltWhen);
+    KStarsDateTime start    = ut;
+
+    // Calculate altitude at the argument time, and whether the target passed the meridian
+    CachingDms const LST = geo->GSTtoLST(ut.gst());
+    o.EquatorialToHorizontal(&LST, geo->lat());
+    double const altitude = o.alt().Degrees();
+
+    double offset = LST.Hours() - o.ra().Hours();
+    if (24.0 <= offset)
+        offset -= 24.0;
+    else if (offset < 0.0)
+        offset += 24.0;
+    bool const isSetting = 0.0 <= offset && offset < 12.0;
+
+    if (!isAltitudeOK(altitude, isSetting))
+    {
+        // Wait for the target to rise over the minimum altitude
+        if (!o.altitudeCrossingUT(ut, geo, getMinAltitude(), true, start))
+        {
+            // Never rising over the minimum altitude
+            if (altitude < getMinAltitude())
+                return QDateTime();
+
+            // Never setting under the minimum altitude, but setting under the cutoff: wait for the lower culmination
+            start = o.hourAngleTimeUT(ut, geo, 180.0);
         }
     }
 
+    // Altitude constraint is stable at minute level, so round up to the next minute after the argument time
+    qint64 const minutes = qMax<qint64>(0, (ut.msecsTo(start) + 59999) / 60000);
+    if (24 * 60 <= minutes)
+        return QDateTime();
+
+    KStarsDateTime const ltStart(ltWhen.addSecs(minutes * 60.0));
+
+    if (getMinMoonSeparation() <= 0)
+        return ltStart;
+
+    // Moon separation has no closed form, so step through the rest of the 24 hours from the altitude crossing
+    for (auto const &sample : calculateAltitudes(ltStart, 60, 24 * 60 - minutes, true))
+    {
+        // Don't test proximity to dawn in this situation, we only cater for altitude here
+        if (isAltitudeOK(sample.altitude, sample.isSetting) && 0 <= sample.moonSeparationScore)
+            return sample.when;
+    }
+
     return QDateTime();
 }
 
 QDateTime SchedulerJob::calculateCulmination(QDateTime const &when) const
+{
+    return cachedEvaluation(evaluationCache.culminationTimes, when, 1, [this](QDateTime const &t)
+    {
+        return evaluateCulmination(t);
+    });
+}
+
+QDateTime SchedulerJob::evaluateCulmination(QDateTime const &when) const
 {
     // FIXME: culmination calculation is a min altitude requirement, should be an interval altitude requirement
-    GeoLocation *geo = KStarsData::Instance()->geo();
+    GeoLocation *geo = getGeo();
     // FIXME: block calculating target coordinates at a particular time is duplicated in calculateCulmination
 
     // Retrieve the argument date/time, or fall back to current time - don't use QDateTime's timezone!
     KStarsDateTime ltWhen(when.isValid() ?
                           Qt::UTC == when.timeSpec() ? geo->UTtoLT(KStarsDateTime(when)) : when :
-                          KStarsData::Instance()->lt());
+                          getLocalTime());
 
     // Create a sky object with the target catalog coordinates
     SkyPoint const target = getTargetCoords();
@@ -983,7 +1238,7 @@ QDateTime SchedulerJob::calculateCulmination(QDateTime const &when) const
     KStarsDateTime observationDateTime = transitDateTime.addSecs(getCulminationOffset() * 60);
 
     // Relax observation time, culmination calculation is stable at minute only
-    KStarsDateTime relaxedDateTime = observationDateTime.addSecs(Options::leadTime() * 60);
+    KStarsDateTime relaxedDateTime = observationDateTime.addSecs(getLeadTimeOption() * 60);
 
     // Verify resulting observation time is under lead time vs. argument time
     // If sooner, delay by 8 hours to get to the next transit - perhaps in a third call
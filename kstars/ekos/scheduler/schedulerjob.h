@@ -9,12 +9,18 @@
 
 #pragma once
 
+#include "geolocation.h"
+#include "kstarsdatetime.h"
 #include "skypoint.h"
 
 #include <QUrl>
+#include <QHash>
 #include <QMap>
+#include <QVector>
 #include "ksmoon.h"
 
+#include <memory>
+
 class QTableWidgetItem;
 class QLabel;
 class KSMoon;
@@ -342,6 +348,41 @@ class SchedulerJob
      */
     void reset();
 
+    /**
+     * @brief Snapshot of the global state job evaluations depend on, so that jobs can be evaluated concurrently.
+     * @details A context copies the KStars geolocation, local time and relevant options, and owns a copy of the Moon.
+     * Each thread evaluating jobs must use its own context. Contexts must be created and destroyed on the main thread.
+     */
+    class EphemerisContext
+    {
+      public:
+        EphemerisContext();
+
+        GeoLocation geo;
+        KStarsDateTime lt;
+        double settingAltitudeCutoff { 0 };
+        double leadTime { 0 };
+        std::unique_ptr<KSMoon> moon;
+    };
+
+    /**
+     * @brief prefetchEvaluation Fill the evaluation cache with the results the scheduler will need when evaluating this job.
+     * @param when date and time of the evaluation.
+     * @param context ephemeris context to use instead of the global KStars state.
+     * @note This may be called from any thread, as long as no other thread uses this job or the context meanwhile.
+     */
+    void prefetchEvaluation(QDateTime const &when, EphemerisContext &context);
+
+    /** @brief Forget all cached evaluation results, see getAltitudeScore(), getMoonSeparationScore(), calculateAltitudeTime() and calculateCulmination(). */
+    void clearEvaluationCache();
+
+    /** @brief Number of evaluations answered from the cache, and number calculated, since the last call to clearEvaluationStatistics(). */
+    /** @{ */
+    uint32_t getEvaluationCacheHits() const { return evaluationCache.hits; }
+    uint32_t getEvaluationCacheMisses() const { return evaluationCache.misses; }
+    void clearEvaluationStatistics();
+    /** @} */
+
     /** @brief Determining whether a SchedulerJob is a duplicate of another.
      * @param a_job is the other SchedulerJob to test duplication against.
      * @return True if objects are different, but name and sequence file are identical, else false.
@@ -389,6 +430,7 @@ class SchedulerJob
     /**
          * @brief getAltitudeScore Get the altitude score of an object. The higher the better
          * @param when date and time to check the target altitude, now if omitted.
+         * @note Results are cached by minute, see clearEvaluationCache().
          * @return Altitude score. Target altitude below minimum altitude required by job or setting target under 3 degrees below minimum altitude get bad score.
          */
     int16_t getAltitudeScore(QDateTime const &when = QDateTime()) const;
@@ -396,6 +438,7 @@ class SchedulerJob
     /**
          * @brief getMoonSeparationScore Get moon separation score. The further apart, the better, up a maximum score of 20.
          * @param when date and time to check the moon separation, now if omitted.
+         * @note Results are cached by minute, see clearEvaluationCache().
          * @return Moon separation score
          */
     int16_t getMoonSeparationScore(QDateTime const &when = QDateTime()) const;
@@ -407,9 +450,38 @@ class SchedulerJob
          */
     double getCurrentMoonSeparation() const;
 
+    /** @brief Target altitude and Moon separation at one date of a time grid, see calculateAltitudes(). */
+    struct AltitudeSample
+    {
+        /** @brief Local date and time of the sample. */
+        QDateTime when;
+        /** @brief Altitude of the target, in degrees. */
+        double altitude { 0 };
+        /** @brief Whether the target passed the meridian. */
+        bool isSetting { false };
+        /** @brief Separation between the target and the Moon in degrees, negative if not calculated. */
+        double moonSeparation { -1 };
+        /** @brief Moon separation score as getMoonSeparationScore() calculates it, zero if not calculated. */
+        int16_t moonSeparationScore { 0 };
+    };
+
+    /**
+         * @brief calculateAltitudes calculate target altitude and Moon separation over a regular time grid.
+         * @param when date and time of the first sample, now if invalid.
+         * @param step number of seconds between two consecutive samples.
+         * @param count number of samples.
+         * @param withMoon whether to calculate Moon separation too, only for samples where the target is at or above the minimum altitude.
+         * @return the samples in chronological order.
+         * @note Time-dependent astronomical quantities are fully calculated once per day of the grid, and interpolated in between.
+         */
+    QVector<AltitudeSample> calculateAltitudes(QDateTime const &when, int step, int count, bool withMoon = false) const;
+
     /**
          * @brief calculateAltitudeTime calculate the altitude time given the minimum altitude given.
+         * @details The altitude crossing is solved with SkyObject::altitudeCrossingUT(). If a minimum Moon separation is
+         * required, the following hours are then stepped through minute by minute with calculateAltitudes().
          * @param when date and time to start searching from, now if omitted.
+         * @note Results are cached by second, see clearEvaluationCache().
          * @return The date and time the target is at or above the argument altitude, valid if found, invalid if not achievable (always under altitude).
          */
     QDateTime calculateAltitudeTime(QDateTime const &when = QDateTime()) const;
@@ -417,6 +489,7 @@ class SchedulerJob
     /**
          * @brief calculateCulmination find culmination time adjust for the job offset
          * @param when date and time to start searching from, now if omitted
+         * @note Results are cached by second, see clearEvaluationCache().
          * @return The date and time the target is in entering the culmination interval, valid if found, invalid if not achievable (currently always valid).
          */
     QDateTime calculateCulmination(QDateTime const &when = QDateTime()) const;
@@ -434,6 +507,43 @@ class SchedulerJob
     static double findAltitude(const SkyPoint &target, const QDateTime &when, bool *is_setting = nullptr, bool debug = false);
 
 private:
+    /** @internal Global state, from the ephemeris context while prefetching. */
+    /** @{ */
+    GeoLocation *getGeo() const;
+    KStarsDateTime getLocalTime() const;
+    KSMoon *getMoon() const;
+    double getSettingAltitudeCutoff() const;
+    double getLeadTimeOption() const;
+    /** @} */
+
+    /** @internal Uncached implementations of getAltitudeScore(), getMoonSeparationScore(), calculateAltitudeTime() and calculateCulmination(). */
+    /** @{ */
+    int16_t evaluateAltitudeScore(QDateTime const &when) const;
+    int16_t evaluateMoonSeparationScore(QDateTime const &when) const;
+    QDateTime evaluateAltitudeTime(QDateTime const &when) const;
+    QDateTime evaluateCulmination(QDateTime const &when) const;
+    /** @} */
+
+    /**
+         * @brief cachedEvaluation Look an evaluation result up in the cache, or calculate and store it.
+         * @param cache the cache of the evaluation.
+         * @param when date and time of the evaluation, now if invalid.
+         * @param bucket duration in seconds over which the result is considered constant.
+         * @param evaluate the uncached evaluation.
+         */
+    template <typename T, typename F>
+    T cachedEvaluation(QHash<qint64, T> &cache, QDateTime const &when, int bucket, F evaluate) const;
+
+    /**
+         * @brief calculateMoonSeparationScore Moon separation score from the relative positions of the target and the Moon.
+         * @param separation Target-Moon separation, in degrees.
+         * @param moonAltitude Altitude of the Moon, in degrees.
+         * @param targetAltitude Altitude of the target, in degrees.
+         * @param illum Lunar illumination, in percent.
+         * @return Moon separation score, see getMoonSeparationScore().
+         */
+    int16_t calculateMoonSeparationScore(double separation, double moonAltitude, double targetAltitude, double illum) const;
+
     QString name;
     SkyPoint targetCoords;
     JOBStatus state { JOB_IDLE };
@@ -500,6 +610,29 @@ private:
 
     QMap<QString, uint16_t> capturedFramesMap;
 
-    /// Pointer to Moon object
-    KSMoon *moon { nullptr };
+    /// Copy of the Moon, positioned at evaluation times without disturbing the Moon of the sky map
+    std::unique_ptr<KSMoon> moon;
+
+    /** @internal Evaluation results, keyed on date and time bucket. */
+    struct EvaluationCache
+    {
+        /// Geolocation and options the results were calculated with
+        double latitude { 0 };
+        double longitude { 0 };
+        double timeZone { 0 };
+        double settingAltitudeCutoff { 0 };
+        double leadTime { 0 };
+
+        QHash<qint64, int16_t> altitudeScores;
+        QHash<qint64, int16_t> moonSeparationScores;
+        QHash<qint64, QDateTime> altitudeTimes;
+        QHash<qint64, QDateTime> culminationTimes;
+
+        uint32_t hits { 0 };
+        uint32_t misses { 0 };
+    };
+    mutable EvaluationCache evaluationCache;
+
+    /// Ephemeris context in use while prefetching, global state is used if null
+    EphemerisContext *ephemerisContext { nullptr };
 };
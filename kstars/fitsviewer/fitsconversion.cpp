@@ -0,0 +1,297 @@
+/***************************************************************************
+                 fitsconversion.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "fitsconversion.h"
+
+#include "fitsdata.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+// Number of buffers kept in the pool once released, and their maximum total size in floats. A couple
+// of frames of a large sensor fit, while the pool does not hold on to more memory than that.
+#define FLOAT_BUFFER_POOL_COUNT 8
+#define FLOAT_BUFFER_POOL_FLOATS (128 * 1024 * 1024)
+
+namespace
+{
+struct PooledBuffer
+{
+    std::unique_ptr<float[]> data;
+    size_t capacity;
+};
+
+QMutex &poolMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+std::vector<PooledBuffer> &pool()
+{
+    static std::vector<PooledBuffer> buffers;
+    return buffers;
+}
+
+size_t &pooledFloats()
+{
+    static size_t floats = 0;
+    return floats;
+}
+
+/* Widen a row of pixels to float. The plain loop is vectorized by the compiler for most types. */
+template <typename T>
+inline void widenRow(T const *source, float *destination, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        destination[i] = source[i];
+}
+
+#ifdef __SSE2__
+// Most cameras send 8 or 16-bit pixels, which SSE2 unpacks to 32-bit integers before converting
+template <>
+inline void widenRow<uint8_t>(uint8_t const *source, float *destination, size_t count)
+{
+    __m128i const zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + i));
+        __m128i const low    = _mm_unpacklo_epi8(pixels, zero);
+        __m128i const high   = _mm_unpackhi_epi8(pixels, zero);
+        _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_ps(destination + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_ps(destination + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+    }
+    for (; i < count; i++)
+        destination[i] = source[i];
+}
+
+template <>
+inline void widenRow<uint16_t>(uint16_t const *source, float *destination, size_t count)
+{
+    __m128i const zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + i));
+        _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(pixels, zero)));
+        _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(pixels, zero)));
+    }
+    for (; i < count; i++)
+        destination[i] = source[i];
+}
+
+template <>
+inline void widenRow<int16_t>(int16_t const *source, float *destination, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        // Each pixel is put in the high half of a 32-bit integer, then shifted down with its sign
+        __m128i const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + i));
+        _mm_storeu_ps(destination + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(pixels, pixels), 16)));
+        _mm_storeu_ps(destination + i + 4, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(pixels, pixels), 16)));
+    }
+    for (; i < count; i++)
+        destination[i] = source[i];
+}
+#endif
+
+template <typename T>
+void convertArea(FITSData const *data, const QRect &area, float *destination)
+{
+    T const *source   = reinterpret_cast<T const *>(data->getImageBuffer());
+    const size_t width = data->width();
+
+    // Full rows are contiguous, and converted at once
+    if (area.x() == 0 && static_cast<size_t>(area.width()) == width)
+    {
+        widenRow(source + area.y() * width, destination, width * area.height());
+        return;
+    }
+
+    for (int y = area.top(); y <= area.bottom(); y++)
+    {
+        widenRow(source + y * width + area.x(), destination, area.width());
+        destination += area.width();
+    }
+}
+}
+
+FITSFloatBuffer::FITSFloatBuffer(size_t size) : m_Size(size)
+{
+    {
+        QMutexLocker locker(&poolMutex());
+        std::vector<PooledBuffer> &buffers = pool();
+
+        // The smallest buffer that is large enough
+        auto best = buffers.end();
+        for (auto buffer = buffers.begin(); buffer != buffers.end(); ++buffer)
+        {
+            if (buffer->capacity >= size && (best == buffers.end() || buffer->capacity < best->capacity))
+                best = buffer;
+        }
+
+        if (best != buffers.end())
+        {
+            m_Data     = std::move(best->data);
+            m_Capacity = best->capacity;
+            pooledFloats() -= m_Capacity;
+            buffers.erase(best);
+            return;
+        }
+    }
+
+    m_Data.reset(new float[size]);
+    m_Capacity = size;
+}
+
+FITSFloatBuffer::FITSFloatBuffer(FITSFloatBuffer &&other)
+    : m_Data(std::move(other.m_Data)), m_Capacity(other.m_Capacity), m_Size(other.m_Size)
+{
+    other.m_Capacity = other.m_Size = 0;
+}
+
+FITSFloatBuffer &FITSFloatBuffer::operator=(FITSFloatBuffer &&other)
+{
+    if (this != &other)
+    {
+        release();
+        m_Data     = std::move(other.m_Data);
+        m_Capacity = other.m_Capacity;
+        m_Size     = other.m_Size;
+        other.m_Capacity = other.m_Size = 0;
+    }
+    return *this;
+}
+
+FITSFloatBuffer::~FITSFloatBuffer()
+{
+    release();
+}
+
+void FITSFloatBuffer::release()
+{
+    if (m_Data == nullptr)
+        return;
+
+    QMutexLocker locker(&poolMutex());
+    std::vector<PooledBuffer> &buffers = pool();
+
+    // Buffers that do not fit in the pool are freed
+    if (buffers.size() < FLOAT_BUFFER_POOL_COUNT && pooledFloats() + m_Capacity <= FLOAT_BUFFER_POOL_FLOATS)
+    {
+        pooledFloats() += m_Capacity;
+        buffers.push_back(PooledBuffer { std::move(m_Data), m_Capacity });
+    }
+
+    m_Data.reset();
+    m_Capacity = m_Size = 0;
+}
+
+namespace FITSConversion
+{
+bool isSupported(int dataType)
+{
+    switch (dataType)
+    {
+        case TBYTE:
+        case TSHORT:
+        case TUSHORT:
+        case TLONG:
+        case TULONG:
+        case TFLOAT:
+        case TLONGLONG:
+        case TDOUBLE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool toFloat(FITSData const *data, const QRect &area, float *destination)
+{
+    const QRect image(0, 0, data->width(), data->height());
+    const QRect rect = area.isNull() ? image : area;
+
+    if (!image.contains(rect))
+        return false;
+
+    switch (data->property("dataType").toInt())
+    {
+        case TBYTE:
+            convertArea<uint8_t>(data, rect, destination);
+            break;
+
+        case TSHORT:
+            convertArea<int16_t>(data, rect, destination);
+            break;
+
+        case TUSHORT:
+            convertArea<uint16_t>(data, rect, destination);
+            break;
+
+        case TLONG:
+            convertArea<int32_t>(data, rect, destination);
+            break;
+
+        case TULONG:
+            convertArea<uint32_t>(data, rect, destination);
+            break;
+
+        case TFLOAT:
+            convertArea<float>(data, rect, destination);
+            break;
+
+        case TLONGLONG:
+            convertArea<int64_t>(data, rect, destination);
+            break;
+
+        case TDOUBLE:
+            convertArea<double>(data, rect, destination);
+            break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+FITSFloatBuffer toFloat(FITSData const *data, const QRect &area)
+{
+    const QRect rect = area.isNull() ? QRect(0, 0, data->width(), data->height()) : area;
+
+    if (!isSupported(data->property("dataType").toInt()))
+        return FITSFloatBuffer();
+
+    FITSFloatBuffer buffer(static_cast<size_t>(rect.width()) * rect.height());
+    if (!toFloat(data, rect, buffer.data()))
+        return FITSFloatBuffer();
+
+    return buffer;
+}
+}
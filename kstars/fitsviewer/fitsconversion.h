@@ -0,0 +1,107 @@
+/***************************************************************************
+                  fitsconversion.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QRect>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class FITSData;
+
+/**
+ * @class FITSFloatBuffer
+ *
+ * A buffer of floats taken from a pool, to which it goes back when destroyed.
+ *
+ * Guiding and focusing convert frames to float several times per second. Reusing the buffers
+ * of the previous frames saves allocating, and faulting in, as many megabytes each time. The pool
+ * keeps a few buffers only, up to a total size, and is shared by all threads.
+ *
+ * The contents of a new buffer are undefined. Buffers can be moved, but not copied.
+ *
+ * @short Pooled scratch buffer of floats
+ */
+class FITSFloatBuffer
+{
+  public:
+    /** @short A null buffer */
+    FITSFloatBuffer() = default;
+
+    /** @short A buffer of size floats, from the pool if one is large enough */
+    explicit FITSFloatBuffer(size_t size);
+
+    FITSFloatBuffer(FITSFloatBuffer &&other);
+    FITSFloatBuffer &operator=(FITSFloatBuffer &&other);
+    ~FITSFloatBuffer();
+
+    FITSFloatBuffer(const FITSFloatBuffer &) = delete;
+    FITSFloatBuffer &operator=(const FITSFloatBuffer &) = delete;
+
+    float *data()
+    {
+        return m_Data.get();
+    }
+    float const *data() const
+    {
+        return m_Data.get();
+    }
+    size_t size() const
+    {
+        return m_Size;
+    }
+    bool isNull() const
+    {
+        return m_Data == nullptr;
+    }
+
+  private:
+    /** @short Give the storage back to the pool */
+    void release();
+
+    std::unique_ptr<float[]> m_Data;
+    size_t m_Capacity { 0 };
+    size_t m_Size { 0 };
+};
+
+/**
+ * Conversion of the pixels of FITS data to float, for the algorithms that work on floats whatever the
+ * data type of the image, such as SEP or the guiding star search.
+ *
+ * Only the first channel of color images is converted.
+ */
+namespace FITSConversion
+{
+/** @return true if pixels of this FITS data type (TBYTE, TUSHORT...) can be converted */
+bool isSupported(int dataType);
+
+/**
+ * @short Convert a rectangle of the image to float
+ * @param data the FITS data
+ * @param area the rectangle to convert, within the image. A null rectangle stands for the whole image.
+ * @param destination receives the area.width() * area.height() pixels, row after row
+ * @return false if the data type is not supported
+ */
+bool toFloat(FITSData const *data, const QRect &area, float *destination);
+
+/**
+ * @short Convert a rectangle of the image to float, in a buffer of the pool
+ * @return the pixels, row after row, or a null buffer if the data type is not supported
+ */
+FITSFloatBuffer toFloat(FITSData const *data, const QRect &area = QRect());
+}
@@ -48,8 +48,10 @@
 #include "fitshistogram.h"
 #endif
 
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <vector>
 
 #include <fits_debug.h>
 
@@ -59,6 +61,9 @@
 #define ZOOM_LOW_INCR  10
 #define ZOOM_HIGH_INCR 50
 
+// Number of points per axis, edges included, of the grid on which the WCS footprint of an image is sampled
+#define WCS_FOOTPRINT_SAMPLES 33
+
 const QString FITSData::m_TemporaryPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
 
 
@@ -90,8 +95,6 @@ FITSData::FITSData(const FITSData * other)
 
 FITSData::~FITSData()
 {
-    int status = 0;
-
     clearImageBuffers();
 
 #ifdef HAVE_WCSLIB
@@ -102,16 +105,12 @@ FITSData::~FITSData()
     if (starCenters.count() > 0)
         qDeleteAll(starCenters);
 
-    delete[] wcs_coord;
-
     if (objList.count() > 0)
         qDeleteAll(objList);
 
     if (fptr != nullptr)
     {
-        fits_flush_file(fptr, &status);
-        fits_close_file(fptr, &status);
-        fptr = nullptr;
+        closeFile();
 
         if (m_isTemporary && autoRemoveTemporaryFITS)
             QFile::remove(m_Filename);
@@ -120,17 +119,31 @@ FITSData::~FITSData()
     qDeleteAll(records);
 }
 
-void FITSData::loadCommon(const QString &inFilename)
+void FITSData::closeFile()
 {
     int status = 0;
-    qDeleteAll(starCenters);
-    starCenters.clear();
 
     if (fptr != nullptr)
     {
         fits_flush_file(fptr, &status);
         fits_close_file(fptr, &status);
         fptr = nullptr;
+    }
+
+    // CFITSIO does not free the memory of files it did not allocate
+    free(m_MemoryFile);
+    m_MemoryFile     = nullptr;
+    m_MemoryFileSize = 0;
+}
+
+void FITSData::loadCommon(const QString &inFilename)
+{
+    qDeleteAll(starCenters);
+    starCenters.clear();
+
+    if (fptr != nullptr)
+    {
+        closeFile();
 
         // If current file is temporary AND
         // Auto Remove Temporary File is Set AND
@@ -225,12 +238,26 @@ bool FITSData::privateLoad(void *fits_buffer, size_t fits_buffer_size, bool sile
     }
     else
     {
-        // Read the FITS file from a memory buffer.
-        void *temp_buffer = fits_buffer;
-        size_t temp_size = fits_buffer_size;
-        if (fits_open_memfile(&fptr, m_Filename.toLatin1().data(), READONLY,
-                              &temp_buffer, &temp_size, 0, nullptr, &status))
+        // Read the FITS file from a copy of the memory buffer. CFITSIO keeps reading from it after
+        // loading, and the copy can be written to add keywords, while the caller may reuse its buffer.
+        m_MemoryFile = malloc(fits_buffer_size);
+        if (m_MemoryFile == nullptr)
+        {
+            errMessage = i18n("Not enough memory to read fits buffer.");
+            if (!silent)
+                KSNotification::error(errMessage, i18n("FITS Open"));
+            qCCritical(KSTARS_FITS) << errMessage;
+            return false;
+        }
+        memcpy(m_MemoryFile, fits_buffer, fits_buffer_size);
+        m_MemoryFileSize = fits_buffer_size;
+
+        if (fits_open_memfile(&fptr, m_Filename.toLatin1().data(), READWRITE,
+                              &m_MemoryFile, &m_MemoryFileSize, 0, realloc, &status))
+        {
+            closeFile();
             return fitsOpenError(status, i18n("Error reading fits buffer."), silent);
+        }
         else
             stats.size = fits_buffer_size;
     }
@@ -358,6 +385,59 @@ bool FITSData::privateLoad(void *fits_buffer, size_t fits_buffer_size, bool sile
     return true;
 }
 
+bool FITSData::persistFile()
+{
+    if (m_MemoryFile == nullptr)
+        return true;
+
+    int status = 0;
+
+    // Remove first otherwise CFITSIO will not create the file
+    QFile::remove(m_Filename);
+
+    if (!copyMemoryFile(m_Filename))
+        return false;
+
+    closeFile();
+
+    // Use open diskfile as it does not use extended file names which has problems opening
+    // files with [ ] or ( ) in their names.
+    if (fits_open_diskfile(&fptr, m_Filename.toLatin1(), READONLY, &status) ||
+            fits_movabs_hdu(fptr, 1, IMAGE_HDU, &status))
+    {
+        fits_report_error(stderr, status);
+        return false;
+    }
+
+    return true;
+}
+
+bool FITSData::copyMemoryFile(const QString &filename)
+{
+    int status = 0;
+    fitsfile *new_fptr = nullptr;
+
+    // All the HDUs are written as they were received, with the keywords added since
+    if (fits_create_diskfile(&new_fptr, filename.toLatin1(), &status) ||
+            fits_copy_file(fptr, new_fptr, 1, 1, 1, &status))
+    {
+        char error_status[512];
+        fits_get_errstatus(status, error_status);
+        qCCritical(KSTARS_FITS) << "FITS: Failed to write" << filename << ":" << error_status;
+        if (new_fptr != nullptr)
+        {
+            status = 0;
+            fits_close_file(new_fptr, &status);
+        }
+        return false;
+    }
+
+    fits_close_file(new_fptr, &status);
+
+    qCDebug(KSTARS_FITS) << "Wrote FITS file from memory:" << filename;
+    return status == 0;
+}
+
 int FITSData::saveFITS(const QString &newFilename)
 {
     if (newFilename == m_Filename)
@@ -375,14 +455,6 @@ int FITSData::saveFITS(const QString &newFilename)
 
     if (HasDebayer)
     {
-        fits_flush_file(fptr, &status);
-        /* close current file */
-        if (fits_close_file(fptr, &status))
-        {
-            fits_report_error(stderr, status);
-            return status;
-        }
-
         // Skip "!" in the beginning of the new file name
         QString finalFileName(newFilename);
 
@@ -391,11 +463,30 @@ int FITSData::saveFITS(const QString &newFilename)
         // Remove first otherwise copy will fail below if file exists
         QFile::remove(finalFileName);
 
-        if (!QFile::copy(m_Filename, finalFileName))
+        // Data loaded from memory has no file to copy, it is written as received instead
+        if (m_MemoryFile != nullptr)
         {
-            qCCritical(KSTARS_FITS()) << "FITS: Failed to copy " << m_Filename << " to " << finalFileName;
-            fptr = nullptr;
-            return -1;
+            if (!copyMemoryFile(finalFileName))
+                return -1;
+
+            closeFile();
+        }
+        else
+        {
+            fits_flush_file(fptr, &status);
+            /* close current file */
+            if (fits_close_file(fptr, &status))
+            {
+                fits_report_error(stderr, status);
+                return status;
+            }
+
+            if (!QFile::copy(m_Filename, finalFileName))
+            {
+                qCCritical(KSTARS_FITS()) << "FITS: Failed to copy " << m_Filename << " to " << finalFileName;
+                fptr = nullptr;
+                return -1;
+            }
         }
 
         if (m_isTemporary && autoRemoveTemporaryFITS)
@@ -447,6 +538,11 @@ int FITSData::saveFITS(const QString &newFilename)
 
     fptr = new_fptr;
 
+    // The new file replaces the one loaded from memory, if any
+    free(m_MemoryFile);
+    m_MemoryFile     = nullptr;
+    m_MemoryFileSize = 0;
+
     if (fits_movabs_hdu(fptr, 1, &exttype, &status))
     {
         fits_report_error(stderr, status);
@@ -969,6 +1065,64 @@ bool FITSData::getRecordValue(const QString &key, QVariant &value) const
     return false;
 }
 
+bool FITSData::setRecordValue(const QString &key, const QVariant &value, const QString &comment)
+{
+    if (fptr == nullptr || m_MemoryFile == nullptr)
+        return false;
+
+    int status = 0;
+    QByteArray keyName    = key.toLatin1();
+    QByteArray keyComment = comment.toLatin1();
+
+    switch (value.type())
+    {
+        case QVariant::Int:
+        {
+            int intValue = value.toInt();
+            fits_update_key(fptr, TINT, keyName.data(), &intValue, keyComment.data(), &status);
+        }
+        break;
+
+        case QVariant::Double:
+        {
+            double doubleValue = value.toDouble();
+            fits_update_key(fptr, TDOUBLE, keyName.data(), &doubleValue, keyComment.data(), &status);
+        }
+        break;
+
+        default:
+            fits_update_key_str(fptr, keyName.data(), value.toString().toLatin1().data(), keyComment.data(), &status);
+            break;
+    }
+
+    if (status)
+    {
+        char error_status[512];
+        fits_get_errstatus(status, error_status);
+        qCWarning(KSTARS_FITS) << "Failed to update keyword" << key << ":" << error_status;
+        return false;
+    }
+
+    // Keep the parsed header in sync with the file
+    for (Record * oneRecord : records)
+    {
+        if (oneRecord->key == key)
+        {
+            oneRecord->value   = value;
+            oneRecord->comment = comment;
+            return true;
+        }
+    }
+
+    Record * oneRecord = new Record;
+    oneRecord->key     = key;
+    oneRecord->value   = value;
+    oneRecord->comment = comment;
+    records.append(oneRecord);
+
+    return true;
+}
+
 int FITSData::findStars(StarAlgorithm algorithm, const QRect &trackingBox)
 {
     int count = 0;
@@ -1654,10 +1808,7 @@ bool FITSData::loadWCS()
 
     int status = 0;
     char * header;
-    int nkeyrec, nreject, nwcs, stat[2];
-    double imgcrd[2], phi = 0, pixcrd[2], theta = 0, world[2];
-    int w  = width();
-    int h = height();
+    int nkeyrec, nreject, nwcs;
 
     if (fits_hdr2str(fptr, 1, nullptr, 0, &header, &nkeyrec, &status))
     {
@@ -1701,42 +1852,15 @@ bool FITSData::loadWCS()
         return false;
     }
 
-    delete[] wcs_coord;
-
-    wcs_coord = new wcs_point[w * h];
-
-    if (wcs_coord == nullptr)
+    // Pixels are converted on demand, so nothing depends on the size of the image
+    if (!findWCSFootprint())
     {
         wcsvfree(&m_nwcs, &m_wcs);
         m_wcs = nullptr;
-        lastError = "Not enough memory for WCS data!";
         return false;
     }
 
-    wcs_point * p = wcs_coord;
-
-    for (int i = 0; i < h; i++)
-    {
-        for (int j = 0; j < w; j++)
-        {
-            pixcrd[0] = j;
-            pixcrd[1] = i;
-
-            if ((status = wcsp2s(m_wcs, 1, 2, &pixcrd[0], &imgcrd[0], &phi, &theta, &world[0], &stat[0])) != 0)
-            {
-                lastError = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
-            }
-            else
-            {
-                p->ra  = world[0];
-                p->dec = world[1];
-
-                p++;
-            }
-        }
-    }
-
-    findObjectsInImage(&world[0], phi, theta, &imgcrd[0], &pixcrd[0], &stat[0]);
+    findObjectsInImage();
 
     WCSLoaded = true;
     HasWCS = true;
@@ -1821,82 +1945,178 @@ bool FITSData::pixelToWCS(const QPointF &wcsPixelPoint, SkyPoint &wcsCoord)
 #endif
 }
 
+bool FITSData::getWCSFootprint(double &minRA, double &maxRA, double &minDec, double &maxDec) const
+{
+    if (!WCSLoaded)
+        return false;
+
+    minRA  = wcsFootprint[0];
+    maxRA  = wcsFootprint[1];
+    minDec = wcsFootprint[2];
+    maxDec = wcsFootprint[3];
+    return true;
+}
+
 #if !defined(KSTARS_LITE) && defined(HAVE_WCSLIB)
-void FITSData::findObjectsInImage(double world[], double phi, double theta, double imgcrd[], double pixcrd[],
-                                  int stat[])
+bool FITSData::findWCSFootprint()
 {
-    int w = width();
-    int h = height();
-    int status = 0;
-    char date[64];
-    KSNumbers * num = nullptr;
+    const int n = WCS_FOOTPRINT_SAMPLES;
+    const double w = width(), h = height();
+
+    // Sample the image on a coarse grid, converted in a single call
+    std::vector<double> pixcrd(2 * n * n), imgcrd(2 * n * n), world(2 * n * n), phi(n * n), theta(n * n);
+    std::vector<int> stat(n * n);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            pixcrd[2 * (i * n + j)]     = j * (w - 1) / (n - 1);
+            pixcrd[2 * (i * n + j) + 1] = i * (h - 1) / (n - 1);
+        }
+    }
+
+    // Pixels outside of the projection are flagged in stat, and left out below
+    int status = wcsp2s(m_wcs, n * n, 2, pixcrd.data(), imgcrd.data(), phi.data(), theta.data(), world.data(),
+                        stat.data());
+    if ((status != 0 && status != WCSERR_BAD_PIX) || stat[n * n / 2] != 0)
+    {
+        lastError = QString("wcsp2s error %1: %2.").arg(status).arg(wcs_errmsg[status]);
+        return false;
+    }
 
-    if (fits_read_keyword(fptr, "DATE-OBS", date, nullptr, &status) == 0)
+    // Unwrap RA around the center of the image, so that images across 0h get a continuous range
+    const double centerRA = world[2 * (n * n / 2)];
+    double minRA = 1000, maxRA = -1000, minDec = 1000, maxDec = -1000;
+    for (int k = 0; k < n * n; k++)
     {
-        QString tsString(date);
-        tsString = tsString.remove('\'').trimmed();
-        // Add Zulu time to indicate UTC
-        tsString += "Z";
+        if (stat[k] != 0)
+            continue;
+
+        double ra = world[2 * k];
+        ra -= 360.0 * std::round((ra - centerRA) / 360.0);
 
-        QDateTime ts = QDateTime::fromString(tsString, Qt::ISODate);
+        minRA  = std::min(minRA, ra);
+        maxRA  = std::max(maxRA, ra);
+        minDec = std::min(minDec, world[2 * k + 1]);
+        maxDec = std::max(maxDec, world[2 * k + 1]);
+    }
 
-        if (ts.isValid())
-            num = new KSNumbers(KStarsDateTime(ts).djd());
+    // An image containing a celestial pole spans all RAs
+    for (double pole : { 90.0, -90.0 })
+    {
+        double poleWorld[2] = { 0, pole }, polePhi, poleTheta, poleImgcrd[2], polePixcrd[2];
+        int poleStat;
+        if (wcss2p(m_wcs, 1, 2, poleWorld, &polePhi, &poleTheta, poleImgcrd, polePixcrd, &poleStat) == 0 &&
+                polePixcrd[0] >= 0 && polePixcrd[0] <= w - 1 && polePixcrd[1] >= 0 && polePixcrd[1] <= h - 1)
+        {
+            minRA = centerRA - 180.0;
+            maxRA = centerRA + 180.0;
+            if (pole > 0)
+                maxDec = pole;
+            else
+                minDec = pole;
+        }
     }
-    if (num == nullptr)
-        num = new KSNumbers(KStarsData::Instance()->ut().djd()); //Set to current time if the above does not work.
 
-    SkyMapComposite * map = KStarsData::Instance()->skyComposite();
+    wcsFootprint[0] = minRA;
+    wcsFootprint[1] = maxRA;
+    wcsFootprint[2] = minDec;
+    wcsFootprint[3] = maxDec;
+    return true;
+}
+
+void FITSData::findObjectsInImage()
+{
+    const int w = width();
+    const int h = height();
+
+    qDeleteAll(objList);
+    objList.clear();
 
-    wcs_point * wcs_coord = getWCSCoord();
-    if (wcs_coord != nullptr)
+    // The image covers the polygon of its corners and of the middles of its sides, on which the sides
+    // are close to great circles in the usual projections
+    double pixcrd[16] = { 0, 0, (w - 1) / 2.0, 0, w - 1.0, 0, w - 1.0, (h - 1) / 2.0,
+                          w - 1.0, h - 1.0, (w - 1) / 2.0, h - 1.0, 0, h - 1.0, 0, (h - 1) / 2.0
+                        };
+    double imgcrd[16], corners[16], phi[8], theta[8];
+    int stat[8];
+
+    int status = wcsp2s(m_wcs, 8, 2, pixcrd, imgcrd, phi, theta, corners, stat);
+    if (status != 0)
     {
-        int size = w * h;
+        qCWarning(KSTARS_FITS) << "wcsp2s error" << status << ":" << wcs_errmsg[status];
+        return;
+    }
 
-        objList.clear();
+    QList<SkyPoint> polygon;
+    for (int k = 0; k < 8; k++)
+    {
+        SkyPoint vertex;
+        vertex.setRA0(dms(corners[2 * k]));
+        vertex.setDec0(dms(corners[2 * k + 1]));
+        polygon.append(vertex);
+    }
 
-        SkyPoint p1;
-        p1.setRA0(dms(wcs_coord[0].ra));
-        p1.setDec0(dms(wcs_coord[0].dec));
-        p1.updateCoordsNow(num);
-        SkyPoint p2;
-        p2.setRA0(dms(wcs_coord[size - 1].ra));
-        p2.setDec0(dms(wcs_coord[size - 1].dec));
-        p2.updateCoordsNow(num);
-        QList<SkyObject *> list = map->findObjectsInArea(p1, p2);
+    const QList<SkyObject *> list = KStarsData::Instance()->skyComposite()->findObjectsInArea(polygon);
 
-        foreach (SkyObject * object, list)
-        {
-            int type = object->type();
-            if (object->name() == "star" || type == SkyObject::PLANET || type == SkyObject::ASTEROID ||
-                    type == SkyObject::COMET || type == SkyObject::SUPERNOVA || type == SkyObject::MOON ||
-                    type == SkyObject::SATELLITE)
-            {
-                //DO NOT DISPLAY, at least for now, because these things move and change.
-            }
+    const int count = list.size();
+    std::vector<double> world(2 * count), objectPixels(2 * count);
+    std::vector<int> objectStat(count);
 
-            int x = -100;
-            int y = -100;
+    for (int k = 0; k < count; k++)
+    {
+        world[2 * k]     = list[k]->ra0().Degrees();
+        world[2 * k + 1] = list[k]->dec0().Degrees();
+    }
 
-            world[0] = object->ra0().Degrees();
-            world[1] = object->dec0().Degrees();
+    // All the objects are projected with one call. wcss2p is not re-entrant on a wcsprm, whose
+    // distortion functions work in scratch buffers of their own. Objects that cannot be projected
+    // are flagged in objectStat, and left out below.
+    if (count > 0)
+    {
+        std::vector<double> objectPhi(count), objectTheta(count), objectImgcrd(2 * count);
 
-            if ((status = wcss2p(m_wcs, 1, 2, &world[0], &phi, &theta, &imgcrd[0], &pixcrd[0], &stat[0])) != 0)
-            {
-                fprintf(stderr, "wcsp2s ERROR %d: %s.\n", status, wcs_errmsg[status]);
-            }
-            else
-            {
-                x = pixcrd[0]; //The X and Y are set to the found position if it does work.
-                y = pixcrd[1];
-            }
+        status = wcss2p(m_wcs, count, 2, world.data(), objectPhi.data(), objectTheta.data(), objectImgcrd.data(),
+                        objectPixels.data(), objectStat.data());
+        if (status != 0 && status != WCSERR_BAD_WORLD)
+        {
+            qCWarning(KSTARS_FITS) << "wcss2p error" << status << ":" << wcs_errmsg[status];
+            return;
+        }
+    }
 
-            if (x > 0 && y > 0 && x < w && y < h)
-                objList.append(new FITSSkyObject(object, x, y));
+    for (int k = 0; k < count; k++)
+    {
+        SkyObject * object = list[k];
+        int type = object->type();
+        if (object->name() == "star" || type == SkyObject::PLANET || type == SkyObject::ASTEROID ||
+                type == SkyObject::COMET || type == SkyObject::SUPERNOVA || type == SkyObject::MOON ||
+                type == SkyObject::SATELLITE)
+        {
+            //DO NOT DISPLAY, at least for now, because these things move and change.
         }
+
+        if (objectStat[k] != 0)
+            continue;
+
+        int x = objectPixels[2 * k];
+        int y = objectPixels[2 * k + 1];
+
+        if (x > 0 && y > 0 && x < w && y < h)
+            objList.append(new FITSSkyObject(object, x, y));
     }
 
-    delete (num);
+    // Brightest first, so that views may label only the brightest objects when zoomed out
+    auto magnitude = [](FITSSkyObject * object)
+    {
+        const float mag = object->skyObject()->mag();
+        // Undefined magnitudes are 99.9, or NaN
+        return std::isnan(mag) ? 99.9f : mag;
+    };
+    std::stable_sort(objList.begin(), objList.end(), [&](FITSSkyObject * a, FITSSkyObject * b)
+    {
+        return magnitude(a) < magnitude(b);
+    });
 }
 #endif
 
@@ -3080,6 +3300,11 @@ bool FITSData::injectWCS(const QString &newWCSFile, double orientation, double r
 
     status = 0;
 
+    // The new file replaces the one loaded from memory, if any
+    free(m_MemoryFile);
+    m_MemoryFile     = nullptr;
+    m_MemoryFileSize = 0;
+
     if (m_isTemporary && autoRemoveTemporaryFITS)
     {
         QFile::remove(m_Filename);
@@ -3292,3 +3517,12 @@ void FITSData::restoreStatistics(Statistic &other)
 {
     stats = other;
 }
+
+void FITSData::refreshStatistics(Statistic const &other)
+{
+    stats = other;
+
+    if (markStars)
+        // Let's try to find star positions again after transformation
+        starsSearched = false;
+}
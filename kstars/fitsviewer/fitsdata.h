@@ -51,12 +51,6 @@ class QProgressDialog;
 class SkyPoint;
 class FITSHistogram;
 
-typedef struct
-{
-    float ra;
-    float dec;
-} wcs_point;
-
 class Edge;
 
 class FITSData : public QObject
@@ -124,6 +118,8 @@ class FITSData : public QObject
 
         /**
          * @brief loadFITSFromMemory Loading FITS from memory buffer.
+         * The buffer is copied, and may be freed or reused once this returns. No file is written: the data
+         * has no file on disk until persistFile() or saveFITS() is called.
          * @param inFilename Potential future path to FITS file (or compressed fits.gz), stored in a fitsdata class variable
          * @param fits_buffer The memory buffer containing the fits data.
          * @param fits_buffer_size The size in bytes of the buffer.
@@ -132,6 +128,20 @@ class FITSData : public QObject
          */
         bool loadFITSFromMemory(const QString &inFilename, void *fits_buffer,
                                 size_t fits_buffer_size, bool silent);
+        /**
+         * @brief persistFile Write data loaded from memory to its file name, as it was received.
+         * The data is read from that file afterwards.
+         * @return true if the file of this data is on disk, false if it could not be written.
+         */
+        bool persistFile();
+        /**
+         * @brief isInMemory
+         * @return true if the data was loaded from memory, and has not been written to disk yet.
+         */
+        bool isInMemory() const
+        {
+            return m_MemoryFile != nullptr;
+        }
         /* Save FITS */
         int saveFITS(const QString &newFilename);
         /* Rescale image lineary from image_buffer, fit to window if desired */
@@ -150,6 +160,8 @@ class FITSData : public QObject
         // Statistics
         void saveStatistics(Statistic &other);
         void restoreStatistics(Statistic &other);
+        /* Use statistics computed elsewhere after the image buffer was modified in place, e.g. by calibration */
+        void refreshStatistics(Statistic const &other);
         Statistic const &getStatistics() const { return stats; };
 
         uint16_t width() const
@@ -231,6 +243,15 @@ class FITSData : public QObject
 
         // FITS Record
         bool getRecordValue(const QString &key, QVariant &value) const;
+        /**
+         * @brief setRecordValue Add a keyword to the FITS header, or update its value.
+         * Only data loaded from memory can be modified, the header of a file on disk is left untouched.
+         * @param key FITS keyword
+         * @param value integer, double or string value
+         * @param comment comment of the keyword
+         * @return true if the header was updated.
+         */
+        bool setRecordValue(const QString &key, const QVariant &value, const QString &comment);
         const QList<Record*> &getRecords() const
         {
             return records;
@@ -262,8 +283,6 @@ class FITSData : public QObject
         int findStars(StarAlgorithm algorithm = ALGORITHM_CENTROID, const QRect &trackingBox = QRect());
 
         // Use SEP (Sextractor Library) to find stars
-        template <typename T>
-        void getFloatBuffer(float *buffer, int x, int y, int w, int h) const;
         int findSEPStars(QList<Edge*>&, const QRect &boundary = QRect()) const;
 
         // Apply ring filter to searched stars
@@ -293,10 +312,12 @@ class FITSData : public QObject
             return WCSLoaded;
         }
 
-        wcs_point *getWCSCoord()
-        {
-            return wcs_coord;
-        }
+        /**
+             * @brief getWCSFootprint Find the range of J2000 coordinates covered by the image, once WCS is loaded.
+             * RA is unwrapped around the center of the image, so minRA may be negative or maxRA above 360.
+             * @return True if WCS is loaded, false otherwise.
+             */
+        bool getWCSFootprint(double &minRA, double &maxRA, double &minDec, double &maxDec) const;
 
         /**
              * @brief wcsToPixel Given J2000 (RA0,DE0) coordinates. Find in the image the corresponding pixel coordinates.
@@ -379,7 +400,7 @@ class FITSData : public QObject
 
 #ifndef KSTARS_LITE
 #ifdef HAVE_WCSLIB
-        void findObjectsInImage(double world[], double phi, double theta, double imgcrd[], double pixcrd[], int stat[]);
+        void findObjectsInImage();
 #endif
 #endif
         QList<FITSSkyObject *> getSkyObjects();
@@ -408,10 +429,13 @@ class FITSData : public QObject
     private:
         void loadCommon(const QString &inFilename);
         bool privateLoad(void *fits_buffer, size_t fits_buffer_size, bool silent);
+        bool copyMemoryFile(const QString &filename);
+        void closeFile();
         void rotWCSFITS(int angle, int mirror);
         int calculateMinMax(bool refresh = false);
         bool checkDebayer();
         void readWCSKeys();
+        bool findWCSFootprint();
 
         // FITS Record
         bool parseHeader();
@@ -455,6 +479,9 @@ class FITSData : public QObject
 #endif
         /// Pointer to CFITSIO FITS file struct
         fitsfile *fptr { nullptr };
+        /// FITS file loaded from memory, which CFITSIO may reallocate when the header grows
+        void *m_MemoryFile { nullptr };
+        size_t m_MemoryFileSize { 0 };
 
         /// FITS image data type (TBYTE, TUSHORT, TINT, TFLOAT, TLONG, TDOUBLE)
         uint32_t m_DataType { 0 };
@@ -493,8 +520,8 @@ class FITSData : public QObject
         /// How many times the image was flipped vertically?
         int flipVCounter { 0 };
 
-        /// Pointer to WCS coordinate data, if any.
-        wcs_point *wcs_coord { nullptr };
+        /// Range of J2000 coordinates covered by the image, in degrees: min RA, max RA, min DE, max DE.
+        double wcsFootprint[4] { 0, 0, 0, 0 };
         /// WCS Struct
         struct wcsprm *m_wcs
         {
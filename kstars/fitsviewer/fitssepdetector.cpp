@@ -21,10 +21,57 @@
 
 #include "sep/sep.h"
 #include "fits_debug.h"
+#include "fitsconversion.h"
 #include "fitssepdetector.h"
 
-FITSStarDetector& FITSSEPDetector::configure(const QString &, const QVariant &)
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <vector>
+
+// With TILE_SIZE -1, frames of at least this many pixels are split in tiles
+#define SEP_TILING_MIN_PIXELS (16 * 1024 * 1024)
+// Size of the tiles of large frames, a multiple of the boxes of the background mesh
+#define SEP_TILE_SIZE 1024
+// Margin of a tile over its neighbours. A star is reported by the tile its center is in, and a margin
+// larger than the HFR aperture lets that tile measure it whole.
+#define SEP_TILE_MARGIN 64
+
+namespace
+{
+// Part of the frame whose background is estimated, and whose sources are extracted, on its own
+struct Tile
 {
+    // Region of the frame in the tile, margins included
+    QRect area;
+    // Region of the frame whose sources are reported by this tile
+    QRect core;
+    FITSFloatBuffer data;
+    sep_bkg * bkg { nullptr };
+    sep_catalog * catalog { nullptr };
+    int status { 0 };
+
+    sep_image image()
+    {
+        return { data.data(), nullptr, nullptr, SEP_TFLOAT, 0, 0, area.width(), area.height(), 0.0, SEP_NOISE_NONE, 1.0, 0.0 };
+    }
+};
+
+// A source extracted from a tile
+struct Detection
+{
+    Tile * tile;
+    int index;
+    double ovalSizeSq;
+};
+}
+
+FITSStarDetector& FITSSEPDetector::configure(const QString &setting, const QVariant &value)
+{
+    if (!setting.compare("TILE_SIZE", Qt::CaseInsensitive))
+        if (value.canConvert <int> ())
+            TILE_SIZE = value.value <int> ();
+
     return *this;
 }
 
@@ -46,7 +93,6 @@ int FITSSEPDetector::findSources(QList<Edge*> &starCenters, const QRect &boundar
     FITSData::Statistic const &stats = image_data->getStatistics();
 
     int x = 0, y = 0, w = stats.width, h = stats.height, maxRadius = 50;
-    std::vector<std::pair<int, double>> ovals;
     constexpr int maxNumCenters = 100;
 
     // We may skip 20% of the stars (those with the largest 20% HFRs) as those are suspect
@@ -62,101 +108,128 @@ int FITSSEPDetector::findSources(QList<Edge*> &starCenters, const QRect &boundar
         maxRadius = w;
     }
 
-    auto * data = new float[w * h];
+    if (!FITSConversion::isSupported(parent()->property("dataType").toInt()))
+        return -1;
 
-    switch (parent()->property("dataType").toInt())
+    // Large frames are split in overlapping tiles, which are processed concurrently
+    int tileSize = TILE_SIZE;
+    if (tileSize < 0)
+        tileSize = static_cast<qint64>(w) * h >= SEP_TILING_MIN_PIXELS ? SEP_TILE_SIZE : 0;
+
+    const QRect frame(x, y, w, h);
+    std::vector<Tile> tiles;
+
+    if (tileSize == 0 || (w <= tileSize && h <= tileSize))
+    {
+        Tile tile;
+        tile.area = tile.core = frame;
+        tiles.push_back(std::move(tile));
+    }
+    else
     {
-        case TBYTE:
-            getFloatBuffer<uint8_t>(data, x, y, w, h, image_data);
-            break;
-        case TSHORT:
-            getFloatBuffer<int16_t>(data, x, y, w, h, image_data);
-            break;
-        case TUSHORT:
-            getFloatBuffer<uint16_t>(data, x, y, w, h, image_data);
-            break;
-        case TLONG:
-            getFloatBuffer<int32_t>(data, x, y, w, h, image_data);
-            break;
-        case TULONG:
-            getFloatBuffer<uint32_t>(data, x, y, w, h, image_data);
-            break;
-        case TFLOAT:
-            memcpy(data, image_data->getImageBuffer(), sizeof(float)*w*h);
-            break;
-        case TLONGLONG:
-            getFloatBuffer<int64_t>(data, x, y, w, h, image_data);
-            break;
-        case TDOUBLE:
-            getFloatBuffer<double>(data, x, y, w, h, image_data);
-            break;
-        default:
-            delete [] data;
-            return -1;
+        for (int ty = 0; ty < h; ty += tileSize)
+            for (int tx = 0; tx < w; tx += tileSize)
+            {
+                Tile tile;
+                tile.core = QRect(x + tx, y + ty, qMin(tileSize, w - tx), qMin(tileSize, h - ty));
+                tile.area = tile.core.adjusted(-SEP_TILE_MARGIN, -SEP_TILE_MARGIN, SEP_TILE_MARGIN, SEP_TILE_MARGIN)
+                            .intersected(frame);
+                tiles.push_back(std::move(tile));
+            }
     }
 
-    float * imback = nullptr;
-    double * flux = nullptr, *fluxerr = nullptr, *area = nullptr;
-    short * flag = nullptr;
     short flux_flag = 0;
     int status = 0;
-    sep_bkg * bkg = nullptr;
-    sep_catalog * catalog = nullptr;
     float conv[] = {1, 2, 1, 2, 4, 2, 1, 2, 1};
     double flux_fractions[2] = {0};
     double requested_frac[2] = { 0.5, 0.99 };
+    std::vector<float> globalRMS;
+    std::vector<Detection> detections;
     QList<Edge *> edges;
 
-    // #0 Create SEP Image structure
-    sep_image im = {data, nullptr, nullptr, SEP_TFLOAT, 0, 0, w, h, 0.0, SEP_NOISE_NONE, 1.0, 0.0};
-
-    // #1 Background estimate
-    status = sep_background(&im, 64, 64, 3, 3, 0.0, &bkg);
-    if (status != 0) goto exit;
+    // #0 Create the float image of each tile, then
+    // #1 Background estimate, and
+    // #2 Background subtraction
+    QtConcurrent::blockingMap(tiles, [&](Tile & tile)
+    {
+        tile.data = FITSConversion::toFloat(image_data, tile.area);
 
-    // #2 Background evaluation
-    imback = (float *)malloc((w * h) * sizeof(float));
-    status = sep_bkg_array(bkg, imback, SEP_TFLOAT);
-    if (status != 0) goto exit;
+        sep_image im = tile.image();
+        tile.status = sep_background(&im, 64, 64, 3, 3, 0.0, &tile.bkg);
+        if (tile.status == 0)
+            tile.status = sep_bkg_subarray(tile.bkg, im.data, im.dtype);
+    });
 
-    // #3 Background subtraction
-    status = sep_bkg_subarray(bkg, im.data, im.dtype);
-    if (status != 0) goto exit;
+    // The detection threshold is the same for all tiles, from the median of their global RMS,
+    // so that tiling changes the detections as little as possible
+    for (const Tile &tile : tiles)
+    {
+        if (tile.status != 0)
+        {
+            status = tile.status;
+            goto exit;
+        }
+        globalRMS.push_back(tile.bkg->globalrms);
+    }
+    std::nth_element(globalRMS.begin(), globalRMS.begin() + globalRMS.size() / 2, globalRMS.end());
 
-    // #4 Source Extraction
+    // #3 Source Extraction
     static int deblendNThresh = 32;
     static double deblendMincont = 0.005;
-    status = sep_extract(&im, 2 * bkg->globalrms, SEP_THRESH_ABS, 10, conv, 3, 3, SEP_FILTER_CONV,
-                         deblendNThresh, deblendMincont, 1, 1.0, &catalog);
-    if (status != 0) goto exit;
-    qCDebug(KSTARS_FITS) << "SEP detected " << catalog->nobj << " stars.";
-
-    // Skip the 20% largest stars if we have plenty.
-    if (catalog->nobj * 0.8 > maxNumCenters)
-        startIndex = catalog->nobj * 0.2;
+    QtConcurrent::blockingMap(tiles, [&](Tile & tile)
+    {
+        sep_image im = tile.image();
+        tile.status = sep_extract(&im, 2 * globalRMS[globalRMS.size() / 2], SEP_THRESH_ABS, 10, conv, 3, 3,
+                                  SEP_FILTER_CONV, deblendNThresh, deblendMincont, 1, 1.0, &tile.catalog);
+    });
 
+    // Each tile keeps the detections centered in its core, so that stars in the margins are kept once.
     // Find the oval sizes for each detection in the detected star catalog, and sort by that. Oval size
     // correlates very well with HFR, so we don't need to call sep_flux_radius on all detections later
     // to find the maxNumCenters largest stars. This can save a lot of time.
-    for (int i = 0; i < catalog->nobj; i++)
+    for (Tile &tile : tiles)
     {
-        const double ovalSizeSq = catalog->a[i]*catalog->a[i] + catalog->b[i]*catalog->b[i];
-        ovals.push_back(std::pair<int, double>(i, ovalSizeSq));
+        if (tile.status != 0)
+        {
+            status = tile.status;
+            goto exit;
+        }
+
+        const sep_catalog * catalog = tile.catalog;
+        for (int i = 0; i < catalog->nobj; i++)
+        {
+            const QPoint center(tile.area.x() + static_cast<int>(floor(catalog->x[i] + 0.5)),
+                                tile.area.y() + static_cast<int>(floor(catalog->y[i] + 0.5)));
+            if (!tile.core.contains(center))
+                continue;
+
+            const double ovalSizeSq = catalog->a[i]*catalog->a[i] + catalog->b[i]*catalog->b[i];
+            detections.push_back({ &tile, i, ovalSizeSq });
+        }
     }
-    std::sort(ovals.begin(), ovals.end(), [](const std::pair<int, double>& o1, const std::pair<int, double>& o2) -> bool { return o1.second > o2.second;});
+    qCDebug(KSTARS_FITS) << "SEP detected " << detections.size() << " stars in " << tiles.size() << " tiles.";
+
+    // Skip the 20% largest stars if we have plenty.
+    if (detections.size() * 0.8 > maxNumCenters)
+        startIndex = detections.size() * 0.2;
+
+    std::sort(detections.begin(), detections.end(), [](const Detection& d1, const Detection& d2) -> bool { return d1.ovalSizeSq > d2.ovalSizeSq;});
 
     // Go through the largest (by oval size) detections and compute the HFR for the first maxNumCenters.
-    for (int index = startIndex; index < catalog->nobj; index++)
+    for (size_t index = startIndex; index < detections.size(); index++)
     {
         if (edges.size() >= maxNumCenters) break;
-        int i = ovals[index].first;
+        Tile &tile = *detections[index].tile;
+        const sep_catalog * catalog = tile.catalog;
+        int i = detections[index].index;
         double flux = catalog->flux[i];
         // Get HFR
+        sep_image im = tile.image();
         sep_flux_radius(&im, catalog->x[i], catalog->y[i], maxRadius, 5, 0, &flux, requested_frac, 2, flux_fractions, &flux_flag);
 
         auto * center = new Edge();
-        center->x = catalog->x[i] + x + 0.5;
-        center->y = catalog->y[i] + y + 0.5;
+        center->x = catalog->x[i] + tile.area.x() + 0.5;
+        center->y = catalog->y[i] + tile.area.y() + 0.5;
         center->val = catalog->peak[i];
         center->sum = flux;
         center->HFR = center->width = flux_fractions[0];
@@ -183,14 +256,11 @@ int FITSSEPDetector::findSources(QList<Edge*> &starCenters, const QRect &boundar
                              << starCenters[i]->sum << starCenters[i]->width << starCenters[i]->HFR;
 
 exit:
-    delete[] data;
-    sep_bkg_free(bkg);
-    sep_catalog_free(catalog);
-    free(imback);
-    free(flux);
-    free(fluxerr);
-    free(area);
-    free(flag);
+    for (Tile &tile : tiles)
+    {
+        sep_bkg_free(tile.bkg);
+        sep_catalog_free(tile.catalog);
+    }
 
     if (status != 0)
     {
@@ -202,28 +272,3 @@ exit:
 
     return starCenters.count();
 }
-
-template <typename T>
-void FITSSEPDetector::getFloatBuffer(float * buffer, int x, int y, int w, int h, FITSData const *data) const
-{
-    auto * rawBuffer = reinterpret_cast<T const *>(data->getImageBuffer());
-
-    if (buffer == nullptr)
-        return;
-
-    float * floatPtr = buffer;
-
-    int x2 = x + w;
-    int y2 = y + h;
-
-    FITSData::Statistic const &stats = data->getStatistics();
-
-    for (int y1 = y; y1 < y2; y1++)
-    {
-        int offset = y1 * stats.width;
-        for (int x1 = x; x1 < x2; x1++)
-        {
-            *floatPtr++ = rawBuffer[offset + x1];
-        }
-    }
-}
@@ -39,19 +39,17 @@ public:
 
     /** @brief Configure the detection method.
      * @see FITSStarDetector::configure().
-     * @note No parameters are currently available for configuration.
-     * @todo Provide parameters for detection configuration.
+     * @see Detection parameters.
+     * @todo Provide more parameters for detection configuration.
      */
     FITSStarDetector & configure(const QString &setting, const QVariant &value) override;
 
 protected:
-    /** @internal Consolidate a float data buffer from FITS data.
-     * @param buffer is the destination float block.
-     * @param x, y, w, h define a (x,y)-(x+w,y+h) sub-frame to extract from the FITS data out to block 'buffer'.
-     * @param image_data is the FITS data block to extract from.
-     */
-    template <typename T>
-    void getFloatBuffer(float * buffer, int x, int y, int w, int h, FITSData const * image_data) const;
+    /** @group Detection parameters. Use the names as strings for FITSStarDetector::configure().
+     * @{ */
+    /** @brief Size in pixels of the tiles processed concurrently, 0 to process the frame at once, or -1 to tile large frames only. Configurable. */
+    int TILE_SIZE { -1 };
+    /** @} */
 };
 
 #endif // FITSSEPDETECTOR_H
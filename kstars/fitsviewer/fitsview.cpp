@@ -45,6 +45,8 @@
 #define ZOOM_LOW_INCR  10
 #define ZOOM_HIGH_INCR 50
 #define FONT_SIZE      14
+// Area of the view, in square pixels, given to each object label
+#define LABEL_AREA     (64 * 64)
 
 namespace
 {
@@ -1071,8 +1073,15 @@ bool FITSView::imageHasWCS()
 void FITSView::drawObjectNames(QPainter * painter, double scale)
 {
     painter->setPen(QPen(QColor(KStarsData::Instance()->colorScheme()->colorNamed("FITSObjectLabelColor"))));
-    foreach (FITSSkyObject * listObject, imageData->getSkyObjects())
+
+    // Objects are sorted brightest first, so labelling only as many as fit in the view at this zoom
+    // acts as a limiting magnitude that gets fainter when zooming in
+    const QList<FITSSkyObject *> &objects = imageData->getSkyObjects();
+    const double area = scale * scale * imageData->width() * imageData->height();
+    const int count   = qMin(objects.size(), qMax(1, static_cast<int>(area / LABEL_AREA)));
+    for (int i = 0; i < count; i++)
     {
+        FITSSkyObject * listObject = objects[i];
         painter->drawRect(listObject->x() * scale - 5, listObject->y() * scale - 5, 10, 10);
         painter->drawText(listObject->x() * scale + 10, listObject->y() * scale + 10, listObject->skyObject()->name());
     }
@@ -1092,28 +1101,9 @@ void FITSView::drawEQGrid(QPainter * painter, double scale)
 
     if (imageData->hasWCS())
     {
-        wcs_point * wcs_coord = imageData->getWCSCoord();
-        if (wcs_coord != nullptr)
+        double minRA, maxRA, minDec, maxDec;
+        if (imageData->getWCSFootprint(minRA, maxRA, minDec, maxDec))
         {
-            const int size      = image_width * image_height;
-            double maxRA  = -1000;
-            double minRA  = 1000;
-            double maxDec = -1000;
-            double minDec = 1000;
-
-            for (int i = 0; i < (size); i++)
-            {
-                double ra  = wcs_coord[i].ra;
-                double dec = wcs_coord[i].dec;
-                if (ra > maxRA)
-                    maxRA = ra;
-                if (ra < minRA)
-                    minRA = ra;
-                if (dec > maxDec)
-                    maxDec = dec;
-                if (dec < minDec)
-                    minDec = dec;
-            }
             auto minDecMinutes = (int)(minDec * 12); //This will force the Dec Scale to 5 arc minutes in the loop
             auto maxDecMinutes = (int)(maxDec * 12);
 
@@ -1188,10 +1178,12 @@ void FITSView::drawEQGrid(QPainter * painter, double scale)
                 {
                     for (int i = 1; i < eqGridPoints.count(); i++)
                         painter->drawLine(eqGridPoints.value(i - 1), eqGridPoints.value(i));
-                    QString str = QString::number(dms(target).hour()) + "h " +
-                                  QString::number(dms(target).minute()) + '\'';
+                    // The footprint may extend below 0h or beyond 24h
+                    const dms targetRA = dms(target).reduce();
+                    QString str = QString::number(targetRA.hour()) + "h " +
+                                  QString::number(targetRA.minute()) + '\'';
                     if  (maxDec <= 50 && maxDec >= -50)
-                        str = str + " " + QString::number(dms(target).second()) + "''";
+                        str = str + " " + QString::number(targetRA.second()) + "''";
                     QPointF pt = getPointForGridLabel(painter, str, scale);
                     if (pt.x() != -100)
                         painter->drawText(pt.x(), pt.y(), str);
@@ -35,9 +35,9 @@
 			             /* thresholding filtered weight-maps */
 
 /* globals */
-int plistexist_cdvalue, plistexist_thresh, plistexist_var;
-int plistoff_value, plistoff_cdvalue, plistoff_thresh, plistoff_var;
-int plistsize;
+SEP_THREAD_LOCAL int plistexist_cdvalue, plistexist_thresh, plistexist_var;
+SEP_THREAD_LOCAL int plistoff_value, plistoff_cdvalue, plistoff_thresh, plistoff_var;
+SEP_THREAD_LOCAL int plistsize;
 size_t extract_pixstack = 1000000;
 
 /* get and set pixstack */
@@ -229,8 +229,8 @@ int sep_extract(sep_image *image, float thresh, int thresh_type,
   mem_pixstack = sep_get_extract_pixstack();
 
   /* seed the random number generator consistently on each call to get
-   * consistent results. rand() is used in deblending. */
-  srand(1);
+   * consistent results. sep_rand() is used in deblending. */
+  sep_srand(1);
 
   /* Noise characteristics of the image: None, scalar or variable? */
   if (image->noise_type == SEP_NOISE_NONE) { } /* nothing to do */
@@ -753,7 +753,7 @@ int sortit(infostruct *info, objliststruct *objlist, int minarea,
 	   int deblend_nthresh, double deblend_mincont, double gain)
 {
   objliststruct	        objlistout, *objlist2;
-  static objstruct	obj;
+  static SEP_THREAD_LOCAL objstruct	obj;
   int 			i, status;
 
   status=RETURN_OK;  
@@ -76,9 +76,9 @@ typedef struct
 
 
 /* globals */
-extern int plistexist_cdvalue, plistexist_thresh, plistexist_var;
-extern int plistoff_value, plistoff_cdvalue, plistoff_thresh, plistoff_var;
-extern int plistsize;
+extern SEP_THREAD_LOCAL int plistexist_cdvalue, plistexist_thresh, plistexist_var;
+extern SEP_THREAD_LOCAL int plistoff_value, plistoff_cdvalue, plistoff_thresh, plistoff_var;
+extern SEP_THREAD_LOCAL int plistsize;
 
 typedef struct
 {
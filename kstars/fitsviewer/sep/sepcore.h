@@ -32,6 +32,13 @@
 #define RELTHRESH_NO_NOISE  9
 #define UNKNOWN_NOISE_TYPE  10
 
+/* storage of the state of an extraction, so that images can be extracted concurrently */
+#if defined(_MSC_VER)
+#define SEP_THREAD_LOCAL __declspec(thread)
+#else
+#define SEP_THREAD_LOCAL __thread
+#endif
+
 #define	BIG 1e+30  /* a huge number (< biggest value a float can store) */
 #define	PI  3.1415926535898
 #define	DEG (PI/180.0)	    /* 1 deg in radians */
@@ -79,6 +86,11 @@ typedef void (*array_writer)(float *ptr, int n, void *target);
 float fqmedian(float *ra, int n);
 void put_errdetail(char *errtext);
 
+/* random numbers for deblending, with a state per thread */
+#define SEP_RAND_MAX 32767
+void sep_srand(unsigned int seed);
+int sep_rand(void);
+
 int get_converter(int dtype, converter *f, int *size);
 int get_array_converter(int dtype, array_converter *f, int *size);
 int get_array_writer(int dtype, array_writer *f, int *size);
@@ -25,7 +25,22 @@
 #define DETAILSIZE 512
 
 char *sep_version_string = "0.6.0";
-static char _errdetail_buffer[DETAILSIZE] = "";
+static SEP_THREAD_LOCAL char _errdetail_buffer[DETAILSIZE] = "";
+static SEP_THREAD_LOCAL unsigned int _rand_state = 1;
+
+/****************************************************************************/
+/* random numbers, as the rand() of the C standard but with a state per thread */
+
+void sep_srand(unsigned int seed)
+{
+  _rand_state = seed;
+}
+
+int sep_rand(void)
+{
+  _rand_state = _rand_state * 1103515245u + 12345u;
+  return (int)((_rand_state / 65536u) % 32768u);
+}
 
 /****************************************************************************/
 /* data type conversion mechanics for runtime type conversion */
@@ -27,6 +27,14 @@
 #include "skyqpainter.h"
 #include "projections/projector.h"
 
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <numeric>
+
+// Bands thinner than this are not worth a thread of their own
+#define MIN_BAND_HEIGHT 64
+
 HIPSRenderer::HIPSRenderer()
 {
     m_scanRender.reset(new ScanRender());
@@ -103,8 +111,14 @@ bool HIPSRenderer::render(uint16_t w, uint16_t h, QImage *hipsImage, const Proje
   bool old = m_scanRender->isBilinearInterpolationEnabled();
   m_scanRender->setBilinearInterpolationEnabled(Options::hIPSBiLinearInterpolation() && (size >= HIPSManager::Instance()->getCurrentTileWidth() || allSky));
 
+  // The grid is painted over each tile as soon as it is rendered, so it needs the serial path
+  m_tiled = Options::tiledSkyMap() && !Options::hIPSShowGrid();
+
   renderRec(allSky, level, centerPix, hipsImage);
 
+  if (m_tiled)
+      renderQuads(hipsImage);
+
   m_scanRender->setBilinearInterpolationEnabled(old);
 
   return true;
@@ -180,7 +194,7 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
       // Hence first point is 0.25, 0.25 in UV coordinate system.
       // Depending on the selected algorithm, the mapping will either utilize nearest neighbour
       // or bilinear interpolation.
-      QPointF uv[16][4] = {{QPointF(.25, .25), QPointF(0.25, 0), QPointF(0, .0),QPointF(0, .25)},
+      static const QPointF uv[16][4] = {{QPointF(.25, .25), QPointF(0.25, 0), QPointF(0, .0),QPointF(0, .25)},
                            {QPointF(.25, .5), QPointF(0.25, 0.25), QPointF(0, .25),QPointF(0, .5)},
                            {QPointF(.5, .25), QPointF(0.5, 0), QPointF(.25, .0),QPointF(.25, .25)},
                            {QPointF(.5, .5), QPointF(0.5, 0.25), QPointF(.25, .25),QPointF(.25, .5)},
@@ -226,7 +240,17 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 
           for (int i = 0; i < 4; i++)
               fineScreenCoords[i] = m_projector->toScreen(&fineSkyPoints[i]);
-          m_scanRender->renderPolygon(3, fineScreenCoords, pDest, image, uv[j]);
+
+          if (m_tiled)
+          {
+              Quad quad;
+              std::copy(fineScreenCoords, fineScreenCoords + 4, quad.points);
+              quad.image = *image;
+              quad.uv    = uv[j];
+              m_quads.append(quad);
+          }
+          else
+              m_scanRender->renderPolygon(3, fineScreenCoords, pDest, image, uv[j]);
           j++;
         }
       }
@@ -256,3 +280,56 @@ bool HIPSRenderer::renderPix(bool allsky, int level, int pix, QImage *pDest)
 
   return false;
 }
+
+void HIPSRenderer::renderQuads(QImage *pDest)
+{
+  if (m_quads.isEmpty())
+      return;
+
+  const int width        = pDest->width();
+  const int height       = pDest->height();
+  const int bands        = qBound(1, QThreadPool::globalInstance()->maxThreadCount(), height / MIN_BAND_HEIGHT);
+  const int bandHeight   = (height + bands - 1) / bands;
+  const int bytesPerLine = pDest->bytesPerLine();
+  const bool bilinear    = m_scanRender->isBilinearInterpolationEnabled();
+  uchar *bits            = pDest->bits();
+
+  // Each ScanRender holds a full scan line table, so they are kept from one frame to the next
+  while (m_bandRenders.size() < static_cast<size_t>(bands))
+      m_bandRenders.emplace_back(new ScanRender());
+
+  QVector<int> bandIndex(bands);
+  std::iota(bandIndex.begin(), bandIndex.end(), 0);
+
+  QtConcurrent::blockingMap(bandIndex, [&](int band)
+  {
+      const int top  = band * bandHeight;
+      const int rows = qMin(bandHeight, height - top);
+      if (rows <= 0)
+          return;
+
+      // The band shares the rows of the destination image, so there is nothing to composite afterwards
+      QImage bandImage(bits + top * bytesPerLine, width, rows, bytesPerLine, pDest->format());
+      ScanRender *scanRender = m_bandRenders[band].get();
+      scanRender->setBilinearInterpolationEnabled(bilinear);
+
+      QPointF points[4];
+      for (const Quad &quad : m_quads)
+      {
+          double minY = quad.points[0].y(), maxY = minY;
+          for (int i = 1; i < 4; i++)
+          {
+              minY = qMin(minY, quad.points[i].y());
+              maxY = qMax(maxY, quad.points[i].y());
+          }
+          if (maxY < top || minY >= top + rows)
+              continue;
+
+          for (int i = 0; i < 4; i++)
+              points[i] = QPointF(quad.points[i].x(), quad.points[i].y() - top);
+          scanRender->renderPolygon(3, points, &bandImage, &quad.image, quad.uv);
+      }
+  });
+
+  m_quads.clear();
+}
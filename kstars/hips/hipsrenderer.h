@@ -25,6 +25,7 @@
 #include "scanrender.h"
 
 #include <memory>
+#include <vector>
 
 class Projector;
 
@@ -42,13 +43,34 @@ signals:
 
 public slots:
 
-private:  
+private:
+  /// A sub-pixel quad of a HiPS tile, queued for rasterization when rendering in tiles
+  struct Quad
+  {
+    QPointF points[4];
+    /// Shallow copy of the tile image, so that it survives eviction from the pixel cache
+    QImage image;
+    /// UV coordinates of the quad in the tile image
+    const QPointF *uv;
+  };
+
+  /**
+   * @short Rasterize the queued quads into horizontal bands of the destination image in parallel
+   * Each band has its own ScanRender, and writes only into its own rows of pDest.
+   */
+  void renderQuads(QImage *pDest);
+
   int m_blocks { 0 };
   int m_rendered { 0 };
   int m_size { 0 };
   QSet<int>  m_renderedMap;
   std::unique_ptr<HEALPix> m_HEALpix;
   std::unique_ptr<ScanRender> m_scanRender;
+  /// Scan line buffers of the bands, when rendering in tiles
+  std::vector<std::unique_ptr<ScanRender>> m_bandRenders;
+  /// Quads waiting for renderQuads(), when rendering in tiles
+  QVector<Quad> m_quads;
+  bool m_tiled { false };
   const Projector *m_projector;
   QColor gridColor;
 };
@@ -336,7 +336,7 @@ void ScanRender::setOpacity(float opacity)
 }
 
 /////////////////////////////////////////////////////////
-void ScanRender::renderPolygon(QImage *dst, QImage *src)
+void ScanRender::renderPolygon(QImage *dst, const QImage *src)
 /////////////////////////////////////////////////////////
 {
   if (bBilinear)
@@ -345,7 +345,7 @@ void ScanRender::renderPolygon(QImage *dst, QImage *src)
     renderPolygonNI(dst, src);
 }
 
-void ScanRender::renderPolygon(int interpolation, QPointF *pts, QImage *pDest, QImage *pSrc, QPointF *uv)
+void ScanRender::renderPolygon(int interpolation, const QPointF *pts, QImage *pDest, const QImage *pSrc, const QPointF *uv)
 {
   QPointF Auv = uv[0];
   QPointF Buv = uv[1];
@@ -414,7 +414,7 @@ void ScanRender::renderPolygon(int interpolation, QPointF *pts, QImage *pDest, Q
 }
 
 ///////////////////////////////////////////////////////////
-void ScanRender::renderPolygonNI(QImage *dst, QImage *src)
+void ScanRender::renderPolygonNI(QImage *dst, const QImage *src)
 ///////////////////////////////////////////////////////////
 {
   int w = dst->width();
@@ -517,7 +517,7 @@ void ScanRender::renderPolygonNI(QImage *dst, QImage *src)
 
 
 ///////////////////////////////////////////////////////////
-void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
+void ScanRender::renderPolygonBI(QImage *dst, const QImage *src)
 ///////////////////////////////////////////////////////////
 {
   int w = dst->width();
@@ -650,7 +650,7 @@ void ScanRender::renderPolygonBI(QImage *dst, QImage *src)
   }
 }
 
-void ScanRender::renderPolygonAlpha(QImage *dst, QImage *src)
+void ScanRender::renderPolygonAlpha(QImage *dst, const QImage *src)
 {
   if (bBilinear)
     renderPolygonAlphaBI(dst, src);
@@ -659,7 +659,7 @@ void ScanRender::renderPolygonAlpha(QImage *dst, QImage *src)
 }
 
 
-void ScanRender::renderPolygonAlphaBI(QImage *dst, QImage *src)
+void ScanRender::renderPolygonAlphaBI(QImage *dst, const QImage *src)
 {
   int w = dst->width();
   int sw = src->width();
@@ -809,7 +809,7 @@ void ScanRender::renderPolygonAlphaBI(QImage *dst, QImage *src)
 
 
 ////////////////////////////////////////////////////////////////
-void ScanRender::renderPolygonAlphaNI(QImage *dst, QImage *src)
+void ScanRender::renderPolygonAlphaNI(QImage *dst, const QImage *src)
 ////////////////////////////////////////////////////////////////
 {
   int w = dst->width();
@@ -42,15 +42,15 @@ class ScanRender
     void scanLine(int x1, int y1, int x2, int y2);
     void scanLine(int x1, int y1, int x2, int y2, float u1, float v1, float u2, float v2);
     void renderPolygon(QColor col, QImage *dst);
-    void renderPolygon(QImage *dst, QImage *src);
-    void renderPolygon(int interpolation, QPointF *pts, QImage *pDest, QImage *pSrc, QPointF *uv);
+    void renderPolygon(QImage *dst, const QImage *src);
+    void renderPolygon(int interpolation, const QPointF *pts, QImage *pDest, const QImage *pSrc, const QPointF *uv);
 
-    void renderPolygonNI(QImage *dst, QImage *src);
-    void renderPolygonBI(QImage *dst, QImage *src);
+    void renderPolygonNI(QImage *dst, const QImage *src);
+    void renderPolygonBI(QImage *dst, const QImage *src);
 
-    void renderPolygonAlpha(QImage *dst, QImage *src);
-    void renderPolygonAlphaBI(QImage *dst, QImage *src);
-    void renderPolygonAlphaNI(QImage *dst, QImage *src);
+    void renderPolygonAlpha(QImage *dst, const QImage *src);
+    void renderPolygonAlphaBI(QImage *dst, const QImage *src);
+    void renderPolygonAlphaNI(QImage *dst, const QImage *src);
 
     void renderPolygonAlpha(QColor col, QImage *dst);
     void setOpacity(float opacity);
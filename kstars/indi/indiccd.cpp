@@ -28,7 +28,9 @@
 
 #include <KNotifications/KNotification>
 #include <QImageReader>
+#include <QRegularExpression>
 #include <QStatusBar>
+#include <QUuid>
 #include <QtConcurrent>
 
 #include <basedevice.h>
@@ -102,6 +104,12 @@ bool WriteImageFileInternal(const QString &filename, char *buffer, const size_t
     return true;
 }
 
+// Internal function to name a temporary image file, which is not created.
+QString tempImageFileName(const QString &format)
+{
+    return QDir::tempPath() + "/fits" + QUuid::createUuid().toString().remove(QRegularExpression("[-{}]")) + format;
+}
+
 // Internal function to write a temporary file image blob to disk.
 bool writeTempImageFile(const QString &format, char * buffer, size_t size, QString *filename)
 {
@@ -1577,14 +1585,48 @@ void CCD::processBLOB(IBLOB *bp)
     // 1. file is preview or batch mode is not enabled
     // 2. file type is not FITS_NORMAL (focus, guide..etc)
     QString filename;
+    FITSData *blob_fits_data = nullptr;
     if (targetChip->isBatchMode() == false || targetChip->getCaptureMode() != FITS_NORMAL)
     {
-        if (!writeTempImageFile(format, static_cast<char *>(bp->blob), bp->size, &filename))
+        // FITS frames that are displayed are decoded once in memory, where the filter is added to
+        // their header. Focus and guide frames are only written if the user opens them in the FITS
+        // Viewer, while previews and align frames are read from disk afterwards (e.g. by the solver).
+        if (BType == BLOB_FITS && targetChip->getCaptureMode() != FITS_CALIBRATE)
+        {
+            filename       = tempImageFileName(format);
+            blob_fits_data = new FITSData(targetChip->getCaptureMode());
+
+            if (!blob_fits_data->loadFITSFromMemory(filename, bp->blob, bp->size, false))
+            {
+                // If reading the blob fails, we treat it the same as exposure failure
+                // and recapture again if possible
+                delete (blob_fits_data);
+                qCCritical(KSTARS_INDI) << "failed reading FITS memory buffer";
+                emit newExposureValue(targetChip, 0, IPS_ALERT);
+                return;
+            }
+
+            if (filter.isEmpty() == false)
+            {
+                QString filt(filter);
+                filt.replace(' ', '_');
+                blob_fits_data->setRecordValue("FILTER", filt, "Filter name");
+            }
+
+            if (targetChip->getCaptureMode() != FITS_FOCUS && targetChip->getCaptureMode() != FITS_GUIDE &&
+                    !blob_fits_data->persistFile())
+            {
+                delete (blob_fits_data);
+                emit BLOBUpdated(nullptr);
+                return;
+            }
+        }
+        else if (!writeTempImageFile(format, static_cast<char *>(bp->blob), bp->size, &filename))
         {
             emit BLOBUpdated(nullptr);
             return;
         }
-        if (BType == BLOB_FITS)
+        else if (BType == BLOB_FITS)
             addFITSKeywords(filename, filter);
 
     }
@@ -1599,8 +1641,12 @@ void CCD::processBLOB(IBLOB *bp)
         }
     }
 
-    // store file name
-    strncpy(BLOBFilename, filename.toLatin1(), MAXINDIFILENAME);
+    // store file name. Frames kept in memory have no file until the user opens them in the FITS Viewer,
+    // so none is published for them (e.g. to INDIDBus::getBLOBFile()).
+    if (blob_fits_data && blob_fits_data->isInMemory())
+        BLOBFilename[0] = '\0';
+    else
+        strncpy(BLOBFilename, filename.toLatin1(), MAXINDIFILENAME);
     bp->aux0 = targetChip;
     bp->aux1 = &BType;
     bp->aux2 = BLOBFilename;
@@ -1706,16 +1752,20 @@ void CCD::processBLOB(IBLOB *bp)
             emit BLOBUpdated(bp);
             return;
         }
-        FITSData *blob_fits_data = new FITSData(targetChip->getCaptureMode());
-
-        if (!blob_fits_data->loadFITSFromMemory(filename, bp->blob, bp->size, false))
+        // Already decoded above, unless it was written to disk first
+        if (blob_fits_data == nullptr)
         {
-            // If reading the blob fails, we treat it the same as exposure failure
-            // and recapture again if possible
-            delete (blob_fits_data);
-            qCCritical(KSTARS_INDI) << "failed reading FITS memory buffer";
-            emit newExposureValue(targetChip, 0, IPS_ALERT);
-            return;
+            blob_fits_data = new FITSData(targetChip->getCaptureMode());
+
+            if (!blob_fits_data->loadFITSFromMemory(filename, bp->blob, bp->size, false))
+            {
+                // If reading the blob fails, we treat it the same as exposure failure
+                // and recapture again if possible
+                delete (blob_fits_data);
+                qCCritical(KSTARS_INDI) << "failed reading FITS memory buffer";
+                emit newExposureValue(targetChip, 0, IPS_ALERT);
+                return;
+            }
         }
 
         displayFits(targetChip, filename, bp, blob_fits_data);    
@@ -165,7 +165,8 @@ class INDIDBus : public QObject
         * @param blobName blob element name
         * @param blobFormat blob element format. It is usually the extension of a file.
         * @param size blob element size in bytes. If -1, then there is an error.
-        * @returns full file name
+        * @returns full file name, or an empty string if the blob is only kept in memory, as for focus and guide
+        * frames. Use getBLOBData in that case.
         */
     Q_SCRIPTABLE QString getBLOBFile(const QString &device, const QString &property, const QString &blobName,
                                      QString &blobFormat, int &size);
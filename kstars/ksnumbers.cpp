@@ -164,11 +164,8 @@ void KSNumbers::computeConstantValues()
     P2B(2, 2) = CYB;
 }
 
-void KSNumbers::updateValues(long double jd)
+void KSNumbers::computeMeanValues(long double jd)
 {
-    dms arg;
-    double args, argc;
-
     days = jd;
 
     // FIXME: What is the source for these algorithms / polynomials / numbers? -- asimha
@@ -223,6 +220,16 @@ void KSNumbers::updateValues(long double jd)
                     27.87 * U * U * U * U * U * U * U * U + 5.79 * U * U * U * U * U * U * U * U * U +
                     2.45 * U * U * U * U * U * U * U * U * U * U;
     Obliquity.setD(23.43929111 + dObliq / 3600.0);
+}
+
+void KSNumbers::updateValues(long double jd)
+{
+    computeMeanValues(jd);
+
+    dms arg;
+    double args, argc;
+    double T2 = T * T;
+    double T3 = T2 * T;
 
     //Nutation parameters
     dms L2, M2, O2;
@@ -378,3 +385,21 @@ void KSNumbers::updateValues(long double jd)
         item *= UA2km;
     }
 }
+
+void KSNumbers::interpolateValues(long double jd, const KSNumbers &from, const KSNumbers &to)
+{
+    computeMeanValues(jd);
+
+    const long double span = to.days - from.days;
+    const double f         = (span == 0) ? 0. : static_cast<double>((jd - from.days) / span);
+
+    deltaEcLong    = from.deltaEcLong + f * (to.deltaEcLong - from.deltaEcLong);
+    deltaObliquity = from.deltaObliquity + f * (to.deltaObliquity - from.deltaObliquity);
+
+    // The precession matrices turn by less than an arcsecond a day, linear interpolation keeps them orthogonal enough
+    P1 = from.P1 + f * (to.P1 - from.P1);
+    P2 = from.P2 + f * (to.P2 - from.P2);
+
+    for (int i = 0; i < 3; i++)
+        vearth[i] = from.vearth[i] + f * (to.vearth[i] - from.vearth[i]);
+}
@@ -134,6 +134,19 @@ class KSNumbers
      */
     void updateValues(long double jd);
 
+    /**
+     * @short update all values for the date given as an argument, interpolating the slowly-varying ones.
+     *
+     * The nutation series, the precession matrices and the velocity of the Earth are linearly
+     * interpolated between @p from and @p to, the other values are computed exactly. This is much
+     * cheaper than updateValues() when sweeping over many dates, and accurate to a few
+     * milliarcseconds as long as @p from and @p to are no more than a day apart.
+     * @param jd the Julian date for which to compute values, usually between the dates of @p from and @p to
+     * @param from instance updated for the start of the sweep
+     * @param to instance updated for the end of the sweep
+     */
+    void interpolateValues(long double jd, const KSNumbers &from, const KSNumbers &to);
+
     /**
      * @return the JD for which these values hold (i.e. the last updated JD)
      */
@@ -142,6 +155,9 @@ class KSNumbers
     inline double vEarth(int i) const { return vearth[i]; }
 
   private:
+    /** @short compute the cheap polynomial values: mean anomalies and longitudes, eccentricity and obliquity */
+    void computeMeanValues(long double jd);
+
     CachingDms Obliquity, L0, P;
     dms K, L, LM, M, M0, O, D, MM, F;
     dms XP, YP, ZP, XB, YB, ZB;
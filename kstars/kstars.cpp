@@ -33,6 +33,7 @@
 #include "dialogs/finddialog.h"
 #include "dialogs/exportimagedialog.h"
 #include "skycomponents/starblockfactory.h"
+#include "skycomponents/starblockloader.h"
 #ifdef HAVE_INDI
 #include "ekos/manager.h"
 #include "indi/drivermanager.h"
@@ -301,6 +302,7 @@ void KStars::releaseResources()
 {
     delete m_KStarsData;
     m_KStarsData = nullptr;
+    StarBlockLoader::Release();
     delete StarBlockFactory::Instance();
     TextureManager::Release();
     SkyQPainter::releaseImageCache();
@@ -487,6 +487,21 @@ class KStars : public KXmlGuiWindow
              */
         Q_SCRIPTABLE Q_NOREPLY void openFITS(const QUrl &imageUrl);
 
+        /** DBUS interface function.  Start or stop profiling the frames of the sky map.
+             * While enabled, the timings and counters of each frame are appended to a rolling CSV log.
+             * @param enable true to start profiling, false to stop
+             */
+        Q_SCRIPTABLE Q_NOREPLY void setFrameProfilerEnabled(bool enable);
+
+        /** DBUS interface function.  Get the profile of the last sky map frame.
+             * @return CSV with columns frame, timestamp, phase, component and value. Times are in microseconds.
+             * Empty if the frame profiler is disabled or no frame was drawn yet.
+             */
+        Q_SCRIPTABLE QString getFrameProfile();
+
+        /** DBUS interface function.  Get the path of the frame profiler CSV log. */
+        Q_SCRIPTABLE QString getFrameProfilerLog();
+
         /** @}*/
 
         /**
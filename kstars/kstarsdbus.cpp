@@ -29,6 +29,7 @@
 #include "skymap.h"
 #include "skycomponents/constellationboundarylines.h"
 #include "skycomponents/skymapcomposite.h"
+#include "skycomponents/skymapprofiler.h"
 #include "skyobjects/deepskyobject.h"
 #include "skyobjects/ksplanetbase.h"
 #include "skyobjects/starobject.h"
@@ -973,6 +974,23 @@ QString KStars::getSkyMapDimensions()
 {
     return (QString::number(map()->width()) + 'x' + QString::number(map()->height()));
 }
+
+void KStars::setFrameProfilerEnabled(bool enable)
+{
+    SkyMapProfiler::Instance()->setEnabled(enable);
+}
+
+QString KStars::getFrameProfile()
+{
+    if (!SkyMapProfiler::isEnabled())
+        return QString();
+    return SkyMapProfiler::Instance()->lastFrame();
+}
+
+QString KStars::getFrameProfilerLog()
+{
+    return SkyMapProfiler::Instance()->logFileName();
+}
 void KStars::printImage(bool usePrintDialog, bool useChartColors)
 {
     //QPRINTER_FOR_NOW
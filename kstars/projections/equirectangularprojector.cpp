@@ -71,6 +71,50 @@ Vector2f EquirectangularProjector::toScreenVec(const SkyPoint *o, bool oRefract,
     return p;
 }
 
+int EquirectangularProjector::toScreenBatch(int count, const double *longitude, const double *latitude,
+        Vector2f *screen, bool *visible) const
+{
+    // Same as toScreenVec(), there is no trigonometry to batch here
+    double const focusX = m_vp.useAltAz ? m_vp.focus->az().reduce().radians() : m_vp.focus->ra().reduce().radians();
+    double const focusY = m_vp.useAltAz ? m_vp.focus->alt().radians() : m_vp.focus->dec().radians();
+    int visibleCount = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        double Y, dX;
+
+        if (m_vp.useAltAz)
+        {
+            if (m_vp.useRefraction)
+                Y = SkyPoint::refract(latitude[i] / dms::DegToRad) * dms::DegToRad; //account for atmospheric refraction
+            else
+                Y = latitude[i];
+            dX = focusX - KSUtils::reduceAngle(longitude[i], 0.0, 2 * dms::PI);
+        }
+        else
+        {
+            dX = KSUtils::reduceAngle(longitude[i], 0.0, 2 * dms::PI) - focusX;
+            Y  = latitude[i];
+        }
+
+        if (!(std::isfinite(Y) && std::isfinite(dX)))
+        {
+            screen[i]  = Vector2f(0, 0);
+            visible[i] = false;
+            continue;
+        }
+
+        dX = KSUtils::reduceAngle(dX, -dms::PI, dms::PI);
+
+        screen[i]  = Vector2f(0.5 * m_vp.width - m_vp.zoomFactor * dX,
+                              0.5 * m_vp.height - m_vp.zoomFactor * (Y - focusY));
+        visible[i] = onScreen(screen[i]);
+        visibleCount += visible[i];
+    }
+
+    return visibleCount;
+}
+
 SkyPoint EquirectangularProjector::fromScreen(const QPointF &p, dms *LST, const dms *lat) const
 {
     SkyPoint result;
@@ -39,6 +39,12 @@ double GnomonicProjector::projectionK(double x) const
     return 1.0 / x;
 }
 
+void GnomonicProjector::projectionKBatch(int count, const double *x, double *k) const
+{
+    Map<const ArrayXd> c(x, count);
+    Map<ArrayXd>(k, count) = c.inverse();
+}
+
 double GnomonicProjector::projectionL(double x) const
 {
     return atan(x);
@@ -39,6 +39,12 @@ double LambertProjector::projectionK(double x) const
     return sqrt(2.0 / (1.0 + x));
 }
 
+void LambertProjector::projectionKBatch(int count, const double *x, double *k) const
+{
+    Map<const ArrayXd> c(x, count);
+    Map<ArrayXd>(k, count) = (2.0 / (1.0 + c)).sqrt();
+}
+
 double LambertProjector::projectionL(double x) const
 {
     return 2.0 * asin(0.5 * x);
@@ -37,6 +37,7 @@ class LambertProjector : public Projector
     double radius() const override;
     double projectionK(double x) const override;
     double projectionL(double x) const override;
+    void projectionKBatch(int count, const double *x, double *k) const override;
 };
 
 #endif // LAMBERTPROJECTOR_H
@@ -40,6 +40,12 @@ double OrthographicProjector::projectionK(double x) const
     return 1.0;
 }
 
+void OrthographicProjector::projectionKBatch(int count, const double *x, double *k) const
+{
+    Q_UNUSED(x);
+    Map<ArrayXd>(k, count).setOnes();
+}
+
 double OrthographicProjector::projectionL(double x) const
 {
     return asin(x);
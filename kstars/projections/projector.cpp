@@ -558,3 +558,87 @@ Vector2f Projector::toScreenVec(const SkyPoint *o, bool oRefract, bool *onVisibl
 #endif
     return Vector2f(x, y);
 }
+
+int Projector::toScreenBatch(int count, const double *longitude, const double *latitude, Vector2f *screen,
+                             bool *visible) const
+{
+    if (count <= 0)
+        return 0;
+
+    Map<const ArrayXd> lon(longitude, count);
+    Map<const ArrayXd> lat(latitude, count);
+    ArrayXd Y, dX;
+
+    if (m_vp.useAltAz)
+    {
+        Y = lat;
+        if (m_vp.useRefraction)
+        {
+            //account for atmospheric refraction
+            for (int i = 0; i < count; i++)
+                Y[i] = SkyPoint::refract(lat[i] / dms::DegToRad) * dms::DegToRad;
+        }
+        dX = m_vp.focus->az().radians() - lon;
+    }
+    else
+    {
+        dX = lon - m_vp.focus->ra().radians();
+        Y  = lat;
+    }
+
+    // No need to reduce dX, it is only used through its sine and cosine here
+    ArrayXd const sinY  = Y.sin();
+    ArrayXd const cosY  = Y.cos();
+    ArrayXd const sindX = dX.sin();
+    ArrayXd const cosdX = dX.cos();
+
+    //c is the cosine of the angular distance from the center
+    ArrayXd const c = m_sinY0 * sinY + m_cosY0 * cosY * cosdX;
+
+    ArrayXd k(count);
+    projectionKBatch(count, c.data(), k.data());
+
+    double origX = m_vp.width / 2;
+    double origY = m_vp.height / 2;
+    double zoom  = m_vp.zoomFactor;
+
+    ArrayXd const x = origX - zoom * k * cosY * sindX;
+    ArrayXd const y = origY - zoom * k * (m_cosY0 * sinY - m_sinY0 * cosY * cosdX);
+
+#ifdef KSTARS_LITE
+    double skyRotation = SkyMapLite::Instance()->getSkyRotation();
+    double cosT = 1, sinT = 0;
+    if (skyRotation != 0)
+        dms(skyRotation).SinCos(sinT, cosT);
+#endif
+
+    double const cosMaxField = cosMaxFieldAngle();
+    int visibleCount = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!(std::isfinite(Y[i]) && std::isfinite(dX[i])))
+        {
+            screen[i]  = Vector2f(0, 0);
+            visible[i] = false;
+            continue;
+        }
+
+#ifdef KSTARS_LITE
+        screen[i] = Vector2f(origX + (x[i] - origX) * cosT - (y[i] - origY) * sinT,
+                             origY + (x[i] - origX) * sinT + (y[i] - origY) * cosT);
+#else
+        screen[i] = Vector2f(x[i], y[i]);
+#endif
+        visible[i] = c[i] > cosMaxField && onScreen(screen[i]);
+        visibleCount += visible[i];
+    }
+
+    return visibleCount;
+}
+
+void Projector::projectionKBatch(int count, const double *x, double *k) const
+{
+    for (int i = 0; i < count; i++)
+        k[i] = projectionK(x[i]);
+}
@@ -42,6 +42,8 @@
 
 #include <cstddef>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 using namespace Eigen;
 
@@ -132,6 +134,32 @@ class Projector
      */
     virtual Vector2f toScreenVec(const SkyPoint *o, bool oRefract = true, bool *onVisibleHemisphere = nullptr) const;
 
+    /**
+     * Batched version of toScreenVec() for point sources, projecting @p count points given as
+     * contiguous arrays of coordinates. Refraction is applied as toScreenVec() does by default.
+     *
+     * The default implementation evaluates each step of the projection over the whole batch with
+     * Eigen array expressions, so that the compiler may vectorize them, and only calls
+     * projectionKBatch() once per batch.
+     *
+     * @param count number of points.
+     * @param longitude azimuths if the view uses horizontal coordinates, right ascensions otherwise, in radians.
+     * @param latitude unrefracted altitudes if the view uses horizontal coordinates, declinations otherwise, in radians.
+     * @param screen receives the screen pixel coordinates of each point.
+     * @param visible receives for each point whether it is on the visible part of the projection and on screen.
+     * @return the number of visible points.
+     */
+    virtual int toScreenBatch(int count, const double *longitude, const double *latitude, Vector2f *screen,
+                              bool *visible) const;
+
+    /**
+     * Gather the coordinates of the given points and project them with toScreenBatch().
+     * Null points are not visible, nor points below the horizon when the ground is filled, as
+     * in checkVisibility().
+     */
+    template <class Point>
+    int toScreenBatch(Point *const *points, int count, Vector2f *screen, bool *visible) const;
+
     /**
      * This is exactly the same as toScreenVec but it returns a QPointF.
      * It just calls toScreenVec and converts the result.
@@ -264,6 +292,12 @@ class Projector
      */
     virtual double projectionK(double x) const { return x; }
 
+    /**
+     * Batched projectionK() used by toScreenBatch(). The default implementation calls
+     * projectionK() for each value, projections should override it with a vectorized expression.
+     */
+    virtual void projectionKBatch(int count, const double *x, double *k) const;
+
     /**
      * This function handles some of the projection-specific code.
      * @see toScreen()
@@ -295,3 +329,46 @@ class Projector
     double m_xrange { 0 };
     bool m_isPoleVisible { false };
 };
+
+template <class Point>
+int Projector::toScreenBatch(Point *const *points, int count, Vector2f *screen, bool *visible) const
+{
+    // Reused across calls, the painting threads each have their own
+    thread_local std::vector<double> longitude, latitude;
+    longitude.resize(count);
+    latitude.resize(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        const Point *p = points[i];
+        if (!p)
+            longitude[i] = latitude[i] = std::numeric_limits<double>::quiet_NaN();
+        else if (m_vp.useAltAz)
+        {
+            longitude[i] = p->az().radians();
+            latitude[i]  = p->alt().radians();
+        }
+        else
+        {
+            longitude[i] = p->ra().radians();
+            latitude[i]  = p->dec().radians();
+        }
+    }
+
+    int visibleCount = toScreenBatch(count, longitude.data(), latitude.data(), screen, visible);
+
+    //Skip objects below the horizon if the ground is drawn, assuming horizontal coordinates are synchronized
+    if (m_vp.fillGround)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (visible[i] && points[i]->alt().Degrees() < -1.0)
+            {
+                visible[i] = false;
+                visibleCount--;
+            }
+        }
+    }
+
+    return visibleCount;
+}
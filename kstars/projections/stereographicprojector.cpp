@@ -39,6 +39,12 @@ double StereographicProjector::projectionK(double x) const
     return 2.0 / (1.0 + x);
 }
 
+void StereographicProjector::projectionKBatch(int count, const double *x, double *k) const
+{
+    Map<const ArrayXd> c(x, count);
+    Map<ArrayXd>(k, count) = 2.0 / (1.0 + c);
+}
+
 double StereographicProjector::projectionL(double x) const
 {
     return 2.0 * atan2(x, 2.0);
@@ -36,6 +36,7 @@ class StereographicProjector : public Projector
     double radius() const override;
     double projectionK(double x) const override;
     double projectionL(double x) const override;
+    void projectionKBatch(int count, const double *x, double *k) const override;
 };
 
 #endif // STEREOGRAPHICPROJECTOR_H
@@ -123,7 +123,7 @@ void AsteroidsComponent::loadDataFromText()
     sequence.append(qMakePair(QString("moid"), KSParser::D_DOUBLE));
     sequence.append(qMakePair(QString("class"), KSParser::D_QSTRING));
 
-    KSParser asteroid_parser(filepath_txt, '#', sequence);
+    KSParser asteroid_parser(textFilePath(), '#', sequence);
 
     QHash<QString, QVariant> row_content;
     while (asteroid_parser.HasNextRow())
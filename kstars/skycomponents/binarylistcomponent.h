@@ -18,11 +18,16 @@
 #pragma once
 
 #include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
 
 #include "listcomponent.h"
 #include "binarylistcomponent.h"
 #include "auxiliary/kspaths.h"
 
+#include <kstars_debug.h>
+
 //TODO: Error Handling - SERIOUSLY
 
 /**
@@ -43,7 +48,12 @@
  * Finally, one has to add this template as a friend class upon deriving it.
  * This is a concession to the already present architecture.
  *
- * File paths are determent by the means of KSPaths::writableLocation.
+ * File paths are determent by the means of KSPaths::writableLocation. The text file is
+ * looked up in the other data locations when there is none in the writable one.
+ *
+ * The binary file starts with a header recording the format version, and the size and
+ * modification time of the text file it was made from. It is made again from the text file
+ * when any of them does not match. The binary is memory mapped while it is read.
  */
 template <class T, typename Component>
 class BinaryListComponent
@@ -94,8 +104,9 @@ protected:
      * @brief loadDataFromBinary
      * @param binfile the binary file
      * @short Loads the component data from the given binary.
+     * @return false if the binary is out of date or unreadable, in which case nothing is loaded
      */
-    virtual void loadDataFromBinary(QFile &binfile);
+    virtual bool loadDataFromBinary(QFile &binfile);
 
     /**
      * @brief writeBinary
@@ -144,12 +155,28 @@ protected:
      */
     virtual void clearData();
 
+    /**
+     * @brief textFilePath
+     * @return the path of the text file to load, the writable one if it exists
+     */
+    QString textFilePath() const;
+
     QString filepath_txt;
     QString filepath_bin;
 
 // Don't allow the children to mess with the Binary Version!
 private:
+    /** @short Write the header identifying the binary format and the text file it is made from */
+    void writeHeader(QDataStream &out) const;
+
+    /** @return true if the header matches the binary format and the current text file */
+    bool checkHeader(QDataStream &in) const;
+
     QDataStream::Version binversion = QDataStream::Qt_5_5;
+    // Bump this when the serialization of any T changes
+    static const quint32 binaryFormatVersion = 2;
+    static const quint32 binaryMagic = 0x4B53424C; // "KSBL"
+    QString filename_txt;
     Component* parent;
 };
 
@@ -159,8 +186,42 @@ template<class T, typename Component>
 template<class T, typename Component>
  BinaryListComponent<T, Component>::BinaryListComponent(Component *parent, QString basename, QString txtExt, QString binExt) : parent { parent }
 {
+     filename_txt = basename + '.' + txtExt;
      filepath_bin = KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + basename + '.' + binExt;
-     filepath_txt = KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + basename + '.' + txtExt;
+     filepath_txt = KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + filename_txt;
+}
+
+template<class T, typename Component>
+QString BinaryListComponent<T, Component>::textFilePath() const
+{
+    if (QFile::exists(filepath_txt))
+        return filepath_txt;
+
+    const QString installed = KSPaths::locate(QStandardPaths::GenericDataLocation, filename_txt);
+    return installed.isEmpty() ? filepath_txt : installed;
+}
+
+template<class T, typename Component>
+void BinaryListComponent<T, Component>::writeHeader(QDataStream &out) const
+{
+    const QFileInfo text(textFilePath());
+    out << quint32(binaryMagic) << quint32(binaryFormatVersion) << qint64(text.exists() ? text.size() : -1)
+        << qint64(text.exists() ? text.lastModified().toMSecsSinceEpoch() : -1);
+}
+
+template<class T, typename Component>
+bool BinaryListComponent<T, Component>::checkHeader(QDataStream &in) const
+{
+    quint32 magic = 0, version = 0;
+    qint64 size = 0, modified = 0;
+    in >> magic >> version >> size >> modified;
+
+    if (in.status() != QDataStream::Ok || magic != binaryMagic || version != binaryFormatVersion)
+        return false;
+
+    // Without a text file, whatever binary we have is the best we can do
+    const QFileInfo text(textFilePath());
+    return !text.exists() || (size == text.size() && modified == text.lastModified().toMSecsSinceEpoch());
 }
 
 template<class T, typename Component>
@@ -180,12 +241,12 @@ void  BinaryListComponent<T, Component>::loadData(bool dropBinaryFile)
         dropBinary();
 
     QFile binfile(filepath_bin);
-    if (binfile.exists()) {
-        loadDataFromBinary(binfile);
-    } else {
-        loadDataFromText();
-        writeBinary(binfile);
-    }
+    if (binfile.exists() && loadDataFromBinary(binfile))
+        return;
+
+    qCInfo(KSTARS) << "Creating" << filepath_bin << "from" << textFilePath();
+    loadDataFromText();
+    writeBinary(binfile);
 }
 
 template<class T, typename Component>
@@ -196,27 +257,53 @@ void  BinaryListComponent<T, Component>::loadDataFromBinary()
 }
 
 template<class T, typename Component>
-void  BinaryListComponent<T, Component>::loadDataFromBinary(QFile &binfile)
+bool  BinaryListComponent<T, Component>::loadDataFromBinary(QFile &binfile)
 {
     // Open our binary file and create a Stream
-    binfile.open(QIODevice::ReadOnly);
-    QDataStream in(&binfile);
+    if (!binfile.open(QIODevice::ReadOnly))
+        return false;
+
+    // Read straight from the page cache if we can, sparing the copies through the file buffer.
+    // The mapping lasts until the file is closed, after all the objects are read.
+    QByteArray contents;
+    uchar *data = binfile.size() > 0 ? binfile.map(0, binfile.size()) : nullptr;
+    if (data)
+        contents = QByteArray::fromRawData(reinterpret_cast<const char *>(data), binfile.size());
+    else
+        contents = binfile.readAll();
+    QDataStream in(contents);
 
     // Use the specified binary version
     // TODO: Place this into the config
     in.setVersion(binversion);
     in.setFloatingPointPrecision(QDataStream::DoublePrecision);
 
+    if (!checkHeader(in))
+    {
+        binfile.close();
+        return false;
+    }
+
     while(!in.atEnd()){
         T *new_object = nullptr;
         in >> new_object;
 
+        if (in.status() != QDataStream::Ok)
+        {
+            delete new_object;
+            qCWarning(KSTARS) << "Corrupt binary file" << filepath_bin;
+            clearData();
+            binfile.close();
+            return false;
+        }
+
         parent->appendListObject(new_object);
         // Add name to the list of object names
         parent->objectNames(T::TYPE).append(new_object->name());
         parent->objectLists(T::TYPE).append(QPair<QString, const SkyObject *>(new_object->name(), new_object));
     }
     binfile.close();
+    return true;
 }
 
 template<class T, typename Component>
@@ -229,18 +316,26 @@ void  BinaryListComponent<T, Component>::writeBinary()
 template<class T, typename Component>
 void  BinaryListComponent<T, Component>::writeBinary(QFile &binfile)
 {
-    // Open our file and create a stream
-    binfile.open(QIODevice::WriteOnly | QIODevice::Truncate);
-    QDataStream out(&binfile);
+    // Write to a temporary file, so that an interrupted write never leaves a truncated binary
+    QSaveFile file(binfile.fileName());
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(KSTARS) << "Cannot write" << binfile.fileName() << ":" << file.errorString();
+        return;
+    }
+    QDataStream out(&file);
     out.setVersion(binversion);
     out.setFloatingPointPrecision(QDataStream::DoublePrecision);
 
+    writeHeader(out);
+
     // Now just dump out everything
     for(auto object : parent->m_ObjectList){
          out << *((T*)object);
     }
 
-    binfile.close();
+    if (!file.commit())
+        qCWarning(KSTARS) << "Cannot write" << binfile.fileName() << ":" << file.errorString();
 }
 
 template<class T, typename Component>
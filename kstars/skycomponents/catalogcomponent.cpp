@@ -152,6 +152,9 @@ void CatalogComponent::update(KSNumbers *)
     if (selected())
     {
         KStarsData *data = KStarsData::Instance();
+
+        // Objects whose horizontal coordinates are out of date, converted together below
+        QVector<SkyPoint *> points;
         foreach (SkyObject *obj, m_ObjectList)
         {
             DeepSkyObject *dso = dynamic_cast<DeepSkyObject *>(obj);
@@ -167,7 +170,7 @@ void CatalogComponent::update(KSNumbers *)
                     {
                         dso->updateCoords(data->updateNum());
                     }
-                    dso->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+                    points.append(dso);
                 }
             }
             else
@@ -180,10 +183,11 @@ void CatalogComponent::update(KSNumbers *)
                     {
                         so->updateCoords(data->updateNum());
                     }
-                    so->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+                    points.append(so);
                 }
             }
         }
+        SkyPoint::EquatorialToHorizontal(points.constData(), points.size(), data->lst(), data->geo()->lat());
         this->updateID = data->updateID();
     }
 }
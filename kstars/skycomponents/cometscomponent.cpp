@@ -48,7 +48,8 @@
 
 #include <cmath>
 
-CometsComponent::CometsComponent(SolarSystemComposite *parent) : SolarSystemListComponent(parent)
+CometsComponent::CometsComponent(SolarSystemComposite *parent) : BinaryListComponent(this, "comets"),
+    SolarSystemListComponent(parent)
 {
     loadData();
 }
@@ -60,7 +61,8 @@ bool CometsComponent::selected()
 
 /*
  * @short Initialize the comets list.
- * Reads in the comets data from the comets.dat file.
+ * Reads in the comets data from the comets.dat file
+ * and writes it into the Binary File;
  *
  * Populate the list of Comets from the data file.
  * The data file is a CSV file with the following columns :
@@ -87,18 +89,12 @@ bool CometsComponent::selected()
  * @li 21 comet nuclear magnitude slope parameter
  * @note See KSComet constructor for more details.
  */
-void CometsComponent::loadData()
+void CometsComponent::loadDataFromText()
 {
     QString name, orbit_id, orbit_class, dimensions;
 
     emitProgressText(i18n("Loading comets"));
 
-    qDeleteAll(m_ObjectList);
-    m_ObjectList.clear();
-
-    objectNames(SkyObject::COMET).clear();
-    objectLists(SkyObject::COMET).clear();
-
     QList<QPair<QString, KSParser::DataTypes>> sequence;
     sequence.append(qMakePair(QString("full name"), KSParser::D_QSTRING));
     sequence.append(qMakePair(QString("epoch_mjd"), KSParser::D_INT));
@@ -122,8 +118,7 @@ void CometsComponent::loadData()
     sequence.append(qMakePair(QString("H"), KSParser::D_SKIP));
     sequence.append(qMakePair(QString("G"), KSParser::D_SKIP));
 
-    QString file_name = KSPaths::locate(QStandardPaths::GenericDataLocation, QString("comets.dat"));
-    KSParser cometParser(file_name, '#', sequence);
+    KSParser cometParser(textFilePath(), '#', sequence);
 
     QHash<QString, QVariant> row_content;
     while (cometParser.HasNextRow())
@@ -266,8 +261,8 @@ void CometsComponent::downloadReady()
     }
 #endif
 
-    // Reload asteroids
-    loadData();
+    // Reload comets, and make the binary file again
+    loadData(true);
 
 #ifdef KSTARS_LITE
     KStarsLite::Instance()->data()->setFullTimeUpdate();
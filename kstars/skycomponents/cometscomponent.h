@@ -17,9 +17,11 @@
 
 #pragma once
 
+#include "binarylistcomponent.h"
 #include "ksparser.h"
 #include "solarsystemlistcomponent.h"
 #include "filedownloader.h"
+#include "skyobjects/kscomet.h"
 
 #include <QList>
 #include <QPointer>
@@ -34,10 +36,12 @@ class SkyLabeler;
  * @author Jason Harris
  * @version 0.1
  */
-class CometsComponent : public QObject, public SolarSystemListComponent
+class CometsComponent : public QObject, public SolarSystemListComponent,
+    virtual public BinaryListComponent<KSComet, CometsComponent>
 {
         Q_OBJECT
 
+        friend class BinaryListComponent<KSComet, CometsComponent>;
     public:
         /**
          * @short Default constructor.
@@ -57,7 +61,7 @@ class CometsComponent : public QObject, public SolarSystemListComponent
         void downloadError(const QString &errorString);
 
     private:
-        void loadData();
+        void loadDataFromText() override;
 
         QPointer<FileDownloader> downloadJob;
 };
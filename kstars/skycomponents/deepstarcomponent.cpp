@@ -22,16 +22,18 @@
 #include "Options.h"
 #ifndef KSTARS_LITE
 #include "skymap.h"
+#include "skymapprofiler.h"
 #endif
 #include "skymesh.h"
 #include "skypainter.h"
 #include "starblock.h"
+#include "starblockloader.h"
+#include "starupdatepool.h"
 #include "starcomponent.h"
 #include "htmesh/MeshIterator.h"
 #include "projections/projector.h"
 
 #include <qplatformdefs.h>
-#include <QtConcurrent>
 #include <QElapsedTimer>
 
 #include <kstars_debug.h>
@@ -53,6 +55,10 @@ DeepStarComponent::DeepStarComponent(SkyComposite *parent, QString fileName, flo
 
 DeepStarComponent::~DeepStarComponent()
 {
+    // The loader may already be released at shutdown, it must not be started again here
+    StarBlockLoader *loader = StarBlockLoader::existingInstance();
+    if (!staticStars && loader)
+        loader->cancel(this);
     if (fileOpened)
         starReader.closeFile();
     fileOpened = false;
@@ -107,6 +113,12 @@ bool DeepStarComponent::loadStaticStars()
     if (htm_level != m_skyMesh->level())
         qCWarning(KSTARS) << "HTM Level in shallow star data file and HTM Level in m_skyMesh do not match. EXPECT TROUBLE!";
 
+    // When the catalog is memory mapped, records are taken straight out of the mapping at their
+    // indexed offset instead of being read one by one through the FILE buffer. They are only
+    // copied out when they need byte swapping.
+    bool mapped = starReader.isMapped();
+    bool swapped = starReader.getByteSwap();
+
     // JM 2012-12-05: Breaking into 2 loops instead of one previously with multiple IF checks for recordSize
     // While the CPU branch prediction might not suffer any penalties since the branch prediction after a few times
     // should always gets it right. It's better to do it this way to avoid any chances since the compiler might not optimize it.
@@ -116,6 +128,7 @@ bool DeepStarComponent::loadStaticStars()
         {
             Trixel trixel   = i;
             quint64 records = starReader.getRecordCount(i);
+            quint64 offset  = starReader.getOffset(i);
             std::shared_ptr<StarBlock> SB(new StarBlock(records));
 
             if (!SB.get())
@@ -124,34 +137,44 @@ bool DeepStarComponent::loadStaticStars()
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
 
+            const StarData *mappedStars = (mapped && !swapped) ? starReader.mappedRecords<StarData>(i) : nullptr;
+
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = fread(&stardata, sizeof(StarData), 1, dataFile);
+                const StarData *record = &stardata;
 
-                if (!fread_success)
+                if (mappedStars)
+                    record = mappedStars + j;
+                else
                 {
-                    qCCritical(KSTARS) << "ERROR: Could not read StarData structure for star #" << j << " under trixel #"
-                                       << trixel;
+                    bool fread_success = mapped ? starReader.readMappedRecord(offset + j * sizeof(StarData), &stardata) :
+                                         fread(&stardata, sizeof(StarData), 1, dataFile);
+
+                    if (!fread_success)
+                    {
+                        qCCritical(KSTARS) << "ERROR: Could not read StarData structure for star #" << j << " under trixel #"
+                                           << trixel;
+                    }
+
+                    /* Swap Bytes when required */
+                    if (swapped)
+                        byteSwap(&stardata);
                 }
 
-                /* Swap Bytes when required */
-                if (starReader.getByteSwap())
-                    byteSwap(&stardata);
-
                 /* Initialize star with data just read. */
                 StarObject *star;
 #ifdef KSTARS_LITE
-                star = &(SB->addStar(stardata)->star);
+                star = &(SB->addStar(*record)->star);
 #else
-                star = SB->addStar(stardata);
+                star = SB->addStar(*record);
 #endif
                 if (star)
                 {
                     //KStarsData* data = KStarsData::Instance();
                     //star->EquatorialToHorizontal( data->lst(), data->geo()->lat() );
                     //if( star->getHDIndex() != 0 )
-                    if (stardata.HD)
-                        m_CatalogNumber.insert(stardata.HD, star);
+                    if (record->HD)
+                        m_CatalogNumber.insert(record->HD, star);
                 }
                 else
                 {
@@ -167,6 +190,7 @@ bool DeepStarComponent::loadStaticStars()
         {
             Trixel trixel   = i;
             quint64 records = starReader.getRecordCount(i);
+            quint64 offset  = starReader.getOffset(i);
             std::shared_ptr<StarBlock> SB(new StarBlock(records));
 
             if (!SB.get())
@@ -175,27 +199,37 @@ bool DeepStarComponent::loadStaticStars()
 
             m_starBlockList.at(trixel)->setStaticBlock(SB);
 
+            const DeepStarData *mappedStars =
+                (mapped && !swapped) ? starReader.mappedRecords<DeepStarData>(i) : nullptr;
+
             for (quint64 j = 0; j < records; ++j)
             {
-                bool fread_success = false;
-                fread_success      = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                const DeepStarData *record = &deepstardata;
 
-                if (!fread_success)
+                if (mappedStars)
+                    record = mappedStars + j;
+                else
                 {
-                    qCCritical(KSTARS) << "Could not read StarData structure for star #" << j << " under trixel #"
-                                       << trixel;
+                    bool fread_success = mapped ? starReader.readMappedRecord(offset + j * sizeof(DeepStarData), &deepstardata) :
+                                         fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+
+                    if (!fread_success)
+                    {
+                        qCCritical(KSTARS) << "Could not read StarData structure for star #" << j << " under trixel #"
+                                           << trixel;
+                    }
+
+                    /* Swap Bytes when required */
+                    if (swapped)
+                        byteSwap(&deepstardata);
                 }
 
-                /* Swap Bytes when required */
-                if (starReader.getByteSwap())
-                    byteSwap(&deepstardata);
-
                 /* Initialize star with data just read. */
                 StarObject *star;
 #ifdef KSTARS_LITE
                 star = &(SB->addStar(stardata)->star);
 #else
-                star = SB->addStar(deepstardata);
+                star = SB->addStar(*record);
 #endif
                 if (star)
                 {
@@ -238,27 +272,43 @@ void DeepStarComponent::update(KSNumbers *)
 {
 }
 
-// TODO: Optimize draw, if it is worth it.
 void DeepStarComponent::draw(SkyPainter *skyp)
 {
 #ifndef KSTARS_LITE
-    if (!fileOpened)
+    // Dynamically loaded blocks are filled by the StarBlockLoader thread, which must not touch them while we draw
+    QMutexLocker cacheLocker(&StarBlockFactory::Instance()->mutex());
+    StarUpdatePool pool;
+
+    if (!prepareDraw(pool))
         return;
 
+    pool.run();
+    drawPrepared(skyp);
+#else
+    Q_UNUSED(skyp)
+#endif
+}
+
+bool DeepStarComponent::prepareDraw(StarUpdatePool &pool)
+{
+#ifndef KSTARS_LITE
+    m_DrawTrixels.clear();
+
+    if (!fileOpened)
+        return false;
+
 #ifdef PROFILE_SINCOS
-    long trig_calls_here      = -dms::trig_function_calls;
-    long trig_redundancy_here = -dms::redundant_trig_function_calls;
-    long cachingdms_bad_uses  = -CachingDms::cachingdms_bad_uses;
-    dms::seconds_in_trig      = 0.;
+    m_TrigCallsHere      = -dms::trig_function_calls;
+    m_TrigRedundancyHere = -dms::redundant_trig_function_calls;
+    m_CachingDmsBadUses  = -CachingDms::cachingdms_bad_uses;
+    dms::seconds_in_trig = 0.;
 #endif
 
 #ifdef PROFILE_UPDATECOORDS
     StarObject::updateCoordsCpuTime = 0.;
     StarObject::starsUpdated        = 0;
 #endif
-    SkyMap *map       = SkyMap::Instance();
-    KStarsData *data  = KStarsData::Instance();
-    UpdateID updateID = data->updateID();
+    SkyMap *map = SkyMap::Instance();
 
     //FIXME_FOV -- maybe not clamp like that...
     float radius = map->projector()->fov();
@@ -284,7 +334,7 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     float maglim = StarComponent::zoomMagnitudeLimit();
 
     if (maglim < triggerMag)
-        return;
+        return false;
 
     m_zoomMagLimit = maglim;
 
@@ -299,11 +349,12 @@ void DeepStarComponent::draw(SkyPainter *skyp)
     if (hideFaintStars && maglim > hideStarsMag)
         maglim = hideStarsMag;
 
+    m_DrawMagLim = maglim;
+
     StarBlockFactory *m_StarBlockFactory = StarBlockFactory::Instance();
     //    m_StarBlockFactory->drawID = m_skyMesh->drawID();
     //    qDebug() << "Mesh size = " << m_skyMesh->size() << "; drawID = " << m_skyMesh->drawID();
     QElapsedTimer t;
-    int nTrixels = 0;
 
     t_dynamicLoad = 0;
     t_updateCache = 0;
@@ -313,75 +364,90 @@ void DeepStarComponent::draw(SkyPainter *skyp)
 
     t.start();
 
-    // Mark used blocks in the LRU Cache. Not required for static stars
-    if (!staticStars)
+    QVector<Trixel> missingTrixels;
+
+    while (region.hasNext())
     {
-        while (region.hasNext())
+        Trixel currentRegion = region.next();
+
+        // Safety check if the current region is in star block list
+        if (currentRegion >= m_starBlockList.size())
+            continue;
+
+        m_DrawTrixels.append(currentRegion);
+        std::shared_ptr<StarBlockList> sbl = m_starBlockList.at(currentRegion);
+
+        // Mark used blocks in the LRU Cache. Not required for static stars
+        if (!staticStars)
         {
-            Trixel currentRegion = region.next();
-            for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
+            for (int i = 0; i < sbl->getBlockCount(); ++i)
             {
-                std::shared_ptr<StarBlock> prevBlock = ((i >= 1) ? m_starBlockList.at(currentRegion)->block(
-                        i - 1) : std::shared_ptr<StarBlock>());
-                std::shared_ptr<StarBlock> block     = m_starBlockList.at(currentRegion)->block(i);
+                std::shared_ptr<StarBlock> prevBlock = ((i >= 1) ? sbl->block(i - 1) : std::shared_ptr<StarBlock>());
+                std::shared_ptr<StarBlock> block     = sbl->block(i);
 
                 if (i == 0 && !m_StarBlockFactory->markFirst(block))
                     qCWarning(KSTARS) << "markFirst failed in trixel" << currentRegion;
                 if (i > 0 && !m_StarBlockFactory->markNext(prevBlock, block))
                     qCWarning(KSTARS) << "markNext failed in trixel" << currentRegion << "while marking block" << i;
-                if (i < m_starBlockList.at(currentRegion)->getBlockCount() &&
-                        m_starBlockList.at(currentRegion)->block(i)->getFaintMag() < maglim)
+                if (i < sbl->getBlockCount() && sbl->block(i)->getFaintMag() < maglim)
                     break;
             }
+
+            // Draw what we have now; missing stars are loaded in the background and trigger a repaint when ready
+            if (sbl->getFaintMag() < maglim && sbl->pendingRecordCount() > 0)
+                missingTrixels.append(currentRegion);
+        }
+
+        // Blocks are sorted by magnitude, so we can stop at the first one that reaches beyond maglim
+        for (int i = 0; i < sbl->getBlockCount(); ++i)
+        {
+            std::shared_ptr<StarBlock> block = sbl->block(i);
+            pool.addBlock(block, maglim);
+            if (block->getFaintMag() > maglim)
+                break;
         }
-        t_updateCache = t.elapsed();
-        region.reset();
     }
+    t_updateCache = t.restart();
 
-    while (region.hasNext())
+    SkyMapProfiler::count(SkyMapProfiler::TrixelsVisited, m_DrawTrixels.size());
+    if (!staticStars)
     {
-        ++nTrixels;
-        Trixel currentRegion = region.next();
+        SkyMapProfiler::count(SkyMapProfiler::StarBlockHits, m_DrawTrixels.size() - missingTrixels.size());
+        SkyMapProfiler::count(SkyMapProfiler::StarBlockMisses, missingTrixels.size());
+        requestBlocks(missingTrixels, focus, radius, maglim);
+    }
 
-        // NOTE: We are guessing that the last 1.5/16 magnitudes in the catalog are just additions and the star catalog
-        //       is actually supposed to reach out continuously enough only to mag m_FaintMagnitude * ( 1 - 1.5/16 )
-        // TODO: Is there a better way? We may have to change the magnitude tolerance if the catalog changes
-        // Static stars need not execute fillToMag
+    t_dynamicLoad = t.elapsed();
+    return true;
+#else
+    Q_UNUSED(pool)
+    return false;
+#endif
+}
 
-        // Safety check if the current region is in star block list
-        if (currentRegion >= m_starBlockList.size())
-            continue;
+void DeepStarComponent::drawPrepared(SkyPainter *skyp)
+{
+#ifndef KSTARS_LITE
+    QElapsedTimer t;
+    t.start();
 
-        //        if (!staticStars && !m_starBlockList.at(currentRegion)->fillToMag(maglim) &&
-        //            maglim <= m_FaintMagnitude * (1 - 1.5 / 16))
-        //        {
-        //            qCWarning(KSTARS) << "SBL::fillToMag( " << maglim << " ) failed for trixel " << currentRegion;
-        //        }
+    const float maglim = m_DrawMagLim;
 
-        t_dynamicLoad += t.restart();
+    for (Trixel currentRegion : m_DrawTrixels)
+    {
+        std::shared_ptr<StarBlockList> sbl = m_starBlockList.at(currentRegion);
 
         //        qDebug() << "Drawing SBL for trixel " << currentRegion << ", SBL has "
         //                 <<  m_starBlockList[ currentRegion ]->getBlockCount() << " blocks";
 
-        // REMARK: The following should never carry state, except for const parameters like updateID and maglim
-        std::function<void(std::shared_ptr<StarBlock>)> mapFunction = [&updateID, &maglim](std::shared_ptr<StarBlock> myBlock)
-        {
-            for (StarObject &star : myBlock->contents())
-            {
-                if (star.updateID != updateID)
-                    star.JITupdate();
-                if (star.mag() > maglim)
-                    break;
-            }
-        };
-
-        QtConcurrent::blockingMap(m_starBlockList.at(currentRegion)->contents(), mapFunction);
-
-        for (int i = 0; i < m_starBlockList.at(currentRegion)->getBlockCount(); ++i)
+        for (int i = 0; i < sbl->getBlockCount(); ++i)
         {
-            std::shared_ptr<StarBlock> block = m_starBlockList.at(currentRegion)->block(i);
+            std::shared_ptr<StarBlock> block = sbl->block(i);
             //            qDebug() << "---> Drawing stars from block " << i << " of trixel " <<
             //                currentRegion << ". SB has " << block->getStarCount() << " stars";
+
+            // Stars are sorted by magnitude, project and draw those bright enough in one batch
+            m_DrawBatch.clear();
             for (int j = 0; j < block->getStarCount(); j++)
             {
                 StarObject *curStar = block->star(j);
@@ -389,33 +455,35 @@ void DeepStarComponent::draw(SkyPainter *skyp)
                 //                qDebug() << "We claim that he's from trixel " << currentRegion
                 //<< ", and indexStar says he's from " << m_skyMesh->indexStar( curStar );
 
-                float mag = curStar->mag();
-
-                if (mag > maglim)
+                if (curStar->mag() > maglim)
                     break;
 
-                if (skyp->drawPointSource(curStar, mag, curStar->spchar()))
-                    visibleStarCount++;
+                m_DrawBatch.append(curStar);
             }
+
+            visibleStarCount += skyp->drawPointSources(m_DrawBatch.constData(), m_DrawBatch.size());
         }
 
         // DEBUG: Uncomment to identify problems with Star Block Factory / preservation of Magnitude Order in the LRU Cache
         //        verifySBLIntegrity();
-        t_drawUnnamed += t.restart();
     }
+    skyp->flushPointSources();
+    t_drawUnnamed = t.elapsed();
+    SkyMapProfiler::count(SkyMapProfiler::StarsDrawn, visibleStarCount);
     m_skyMesh->inDraw(false);
+
 #ifdef PROFILE_SINCOS
-    trig_calls_here += dms::trig_function_calls;
-    trig_redundancy_here += dms::redundant_trig_function_calls;
-    cachingdms_bad_uses += CachingDms::cachingdms_bad_uses;
-    qDebug() << "Spent " << dms::seconds_in_trig << " seconds doing " << trig_calls_here
+    m_TrigCallsHere += dms::trig_function_calls;
+    m_TrigRedundancyHere += dms::redundant_trig_function_calls;
+    m_CachingDmsBadUses += CachingDms::cachingdms_bad_uses;
+    qDebug() << "Spent " << dms::seconds_in_trig << " seconds doing " << m_TrigCallsHere
              << " trigonometric function calls amounting to an average of "
-             << 1000.0 * dms::seconds_in_trig / double(trig_calls_here) << " ms per call";
+             << 1000.0 * dms::seconds_in_trig / double(m_TrigCallsHere) << " ms per call";
     qDebug() << "Redundancy of trig calls in this draw: "
-             << double(trig_redundancy_here) / double(trig_calls_here) * 100. << "%";
+             << double(m_TrigRedundancyHere) / double(m_TrigCallsHere) * 100. << "%";
     qDebug() << "CachedDms constructor calls so far: " << CachingDms::cachingdms_constructor_calls;
     qDebug() << "Caching has prevented " << CachingDms::cachingdms_delta << " redundant trig function calls";
-    qDebug() << "Bad cache uses in this draw: " << cachingdms_bad_uses;
+    qDebug() << "Bad cache uses in this draw: " << m_CachingDmsBadUses;
 #endif
 #ifdef PROFILE_UPDATECOORDS
     qDebug() << "Spent " << StarObject::updateCoordsCpuTime << " seconds updating " << StarObject::starsUpdated
@@ -428,6 +496,46 @@ void DeepStarComponent::draw(SkyPainter *skyp)
 #endif
 }
 
+void DeepStarComponent::requestBlocks(const QVector<Trixel> &missing, const SkyPoint *focus, float radius, float maglim)
+{
+    QVector<Trixel> trixels = missing;
+
+    // Extrapolate the motion of the focus since the previous draw, and prefetch the view we are heading to.
+    // Only do so for moderate motions, a jump across the sky is not a slew we can predict.
+    double dRA  = focus->ra().Degrees() - m_PreviousFocusRA;
+    double dDec = focus->dec().Degrees() - m_PreviousFocusDec;
+    if (dRA > 180.0)
+        dRA -= 360.0;
+    else if (dRA < -180.0)
+        dRA += 360.0;
+
+    bool slewing = m_PreviousFocusRA >= 0 && (dRA != 0.0 || dDec != 0.0) &&
+                   fabs(dRA * cos(focus->dec().radians())) < radius && fabs(dDec) < radius;
+
+    m_PreviousFocusRA  = focus->ra().Degrees();
+    m_PreviousFocusDec = focus->dec().Degrees();
+
+    if (slewing)
+    {
+        SkyPoint predicted(dms(focus->ra().Degrees() + dRA).reduce(),
+                           dms(qBound(-90.0, focus->dec().Degrees() + dDec, 90.0)));
+
+        m_skyMesh->aperture(&predicted, radius + 1.0, OBJ_NEAREST_BUF);
+        MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
+        while (region.hasNext())
+        {
+            Trixel trixel = region.next();
+            if (trixel >= m_starBlockList.size() || trixels.contains(trixel))
+                continue;
+            if (m_starBlockList.at(trixel)->getFaintMag() < maglim && m_starBlockList.at(trixel)->pendingRecordCount() > 0)
+                trixels.append(trixel);
+        }
+    }
+
+    if (!trixels.isEmpty())
+        StarBlockLoader::Instance()->request(this, trixels, maglim);
+}
+
 bool DeepStarComponent::openDataFile()
 {
     if (starReader.getFileHandle())
@@ -467,6 +575,9 @@ bool DeepStarComponent::openDataFile()
         ret = fread(&MSpT, 2, 1, starReader.getFileHandle());
         if (starReader.getByteSwap())
             MSpT = bswap_16(MSpT);
+        if (!starReader.mapFile())
+            qCWarning(KSTARS) << "Could not memory map" << dataFileName << ":" << starReader.getError()
+                              << ". Falling back to buffered reads.";
         fileOpened = true;
         qCInfo(KSTARS) << "  Sky Mesh Size: " << m_skyMesh->size();
         for (long int i = 0; i < m_skyMesh->size(); i++)
@@ -510,6 +621,7 @@ SkyObject *DeepStarComponent::objectNearest(SkyPoint *p, double &maxrad)
     m_skyMesh->index(p, maxrad + 1.0, OBJ_NEAREST_BUF);
 
     MeshIterator region(m_skyMesh, OBJ_NEAREST_BUF);
+    QMutexLocker cacheLocker(staticStars ? nullptr : &StarBlockFactory::Instance()->mutex());
 
     while (region.hasNext())
     {
@@ -576,6 +688,8 @@ bool DeepStarComponent::starsInAperture(QList<StarObject *> &list, const SkyPoin
     if (maglim < -28)
         maglim = m_FaintMagnitude;
 
+    QMutexLocker cacheLocker(staticStars ? nullptr : &StarBlockFactory::Instance()->mutex());
+
     while (region.hasNext())
     {
         Trixel currentRegion = region.next();
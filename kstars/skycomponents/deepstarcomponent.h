@@ -38,6 +38,7 @@ class SkyMesh;
 class StarBlockFactory;
 class StarBlockList;
 class StarObject;
+class StarUpdatePool;
 
 class DeepStarComponent : public ListComponent
 {
@@ -58,6 +59,23 @@ class DeepStarComponent : public ListComponent
 
     void draw(SkyPainter *skyp) override;
 
+    /**
+     * @short First half of draw(): find the trixels in view and queue their stars for update
+     *
+     * Splitting draw() in two lets StarComponent update the stars of all its catalogs in a single
+     * parallel pass before drawing any of them.
+     * @param pool The pool to queue the visible StarBlocks into
+     * @return true if drawPrepared() should be called once the pool has run
+     * @note The StarBlockFactory mutex must be held from this call until drawPrepared() returns
+     */
+    bool prepareDraw(StarUpdatePool &pool);
+
+    /**
+     * @short Second half of draw(): draw the stars of the trixels found by prepareDraw()
+     * @note The stars must have been updated by running the pool given to prepareDraw()
+     */
+    void drawPrepared(SkyPainter *skyp);
+
     bool loadStaticStars();
 
     bool openDataFile();
@@ -87,6 +105,14 @@ class DeepStarComponent : public ListComponent
 
     inline BinFileHelper *getStarReader() { return &starReader; }
 
+    /**
+     * @return the StarBlockList holding the stars of the given trixel, or an empty pointer if out of range
+     */
+    inline std::shared_ptr<StarBlockList> starBlockList(Trixel trixel) const
+    {
+        return (trixel >= 0 && trixel < m_starBlockList.size()) ? m_starBlockList.at(trixel) : std::shared_ptr<StarBlockList>();
+    }
+
     bool verifySBLIntegrity();
 
     /**
@@ -113,6 +139,24 @@ class DeepStarComponent : public ListComponent
     static StarBlockFactory m_StarBlockFactory;
 
   private:
+    /**
+     * @short Queue the trixels of the current and the predicted view that lack stars down to maglim
+     * for loading by the StarBlockLoader
+     * @param missing Trixels of the current view that are not loaded deep enough
+     * @param focus Current focus of the sky map
+     * @param radius Radius of the drawn aperture in degrees
+     * @param maglim Magnitude to load the trixels to
+     * @note The StarBlockFactory mutex must be held
+     */
+    void requestBlocks(const QVector<Trixel> &missing, const SkyPoint *focus, float radius, float maglim);
+
+    /// Trixels found in view by prepareDraw()
+    QVector<Trixel> m_DrawTrixels;
+    /// Magnitude limit of the stars to draw, set by prepareDraw()
+    float m_DrawMagLim { 0 };
+    /// Stars of the StarBlock being drawn by drawPrepared(), kept to reuse the allocation
+    QVector<StarObject *> m_DrawBatch;
+
     SkyMesh *m_skyMesh { nullptr };
     KSNumbers m_reindexNum;
 
@@ -132,6 +176,17 @@ class DeepStarComponent : public ListComponent
     long unsigned t_drawUnnamed { 0 };
     long unsigned t_updateCache { 0 };
 
+#ifdef PROFILE_SINCOS
+    // Trigonometry counters, from prepareDraw() to drawPrepared()
+    long m_TrigCallsHere { 0 };
+    long m_TrigRedundancyHere { 0 };
+    long m_CachingDmsBadUses { 0 };
+#endif
+
+    /// Focus at the previous draw, used to predict where the view is slewing to
+    double m_PreviousFocusRA { -1 };
+    double m_PreviousFocusDec { 0 };
+
     QVector<std::shared_ptr<StarBlockList>> m_starBlockList;
     QHash<int, StarObject *> m_CatalogNumber;
 
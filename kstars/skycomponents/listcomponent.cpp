@@ -61,12 +61,16 @@ void ListComponent::update(KSNumbers *num)
     if (!selected())
         return;
     KStarsData *data = KStarsData::Instance();
+
+    QVector<SkyPoint *> points;
+    points.reserve(m_ObjectList.size());
     foreach (SkyObject *o, m_ObjectList)
     {
         if (num)
             o->updateCoords(num);
-        o->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+        points.append(o);
     }
+    SkyPoint::EquatorialToHorizontal(points.constData(), points.size(), data->lst(), data->geo()->lat());
 }
 
 SkyObject *ListComponent::findByName(const QString &name)
@@ -32,8 +32,10 @@ void NoPrecessIndex::JITupdate(LineList *lineList)
     lineList->updateID = data->updateID();
     SkyList *points    = lineList->points();
 
-    for (const auto &point : *points)
-    {
-        point->EquatorialToHorizontal(data->lst(), data->geo()->lat());
-    }
+    // The points are only drawn, so the single precision conversion will do
+    static thread_local QVector<SkyPoint *> rawPoints;
+    rawPoints.resize(points->size());
+    for (int i = 0; i < points->size(); ++i)
+        rawPoints[i] = points->at(i).get();
+    SkyPoint::EquatorialToHorizontal(rawPoints.constData(), rawPoints.size(), data->lst(), data->geo()->lat(), true);
 }
@@ -0,0 +1,221 @@
+/***************************************************************************
+                 orbitpropagator.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "orbitpropagator.h"
+
+#include "ksnumbers.h"
+#include "kstarsdatetime.h"
+#include "skyobjects/ksasteroid.h"
+#include "skyobjects/kscomet.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <cmath>
+#include <typeinfo>
+
+// Below this many bodies per chunk, the cost of dispatching a chunk is no longer negligible
+#define MIN_CHUNK_BODIES 64
+// Number of chunks per thread we aim for, so that threads finishing early have something to pick up
+#define CHUNKS_PER_THREAD 4
+// Newton iterations on Kepler's equation stop once the eccentric anomaly moves less than this, in radians
+#define KEPLER_TOLERANCE 1e-10
+#define MAX_KEPLER_ITERATIONS 50
+
+bool OrbitPropagator::addBody(KSPlanetBase *body)
+{
+    // Subclasses, like KSPluto, may find their position otherwise
+    if (typeid(*body) == typeid(KSAsteroid))
+    {
+        KSAsteroid *asteroid = static_cast<KSAsteroid *>(body);
+        if (asteroid->e >= 1.0 || !asteroid->toCalculate())
+            return false;
+    }
+    else if (typeid(*body) == typeid(KSComet))
+    {
+        // Near-parabolic orbits use another approximation, see KSComet::findGeocentricPosition()
+        if (static_cast<KSComet *>(body)->e > 0.98)
+            return false;
+    }
+    else
+        return false;
+
+    m_Queue.append(body);
+    return true;
+}
+
+void OrbitPropagator::loadElements()
+{
+    m_Bodies           = m_Queue;
+    const size_t count = m_Bodies.size();
+
+    for (std::vector<double> *array : { &m_T0, &m_M0, &m_n, &m_a, &m_e, &m_b, &m_M, &m_E })
+        array->resize(count);
+    for (int k = 0; k < 3; ++k)
+    {
+        m_P[k].resize(count);
+        m_Q[k].resize(count);
+        m_X[k].resize(count);
+    }
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        const dms *i, *w, *N;
+        double P;
+
+        if (m_Bodies[j]->type() == SkyObject::ASTEROID)
+        {
+            const KSAsteroid *asteroid = static_cast<const KSAsteroid *>(m_Bodies[j]);
+            m_T0[j]                    = double(asteroid->JD - J2000);
+            m_M0[j]                    = asteroid->M.radians();
+            m_a[j]                     = asteroid->a;
+            m_e[j]                     = asteroid->e;
+            P                          = asteroid->P;
+            i                          = &asteroid->i;
+            w                          = &asteroid->w;
+            N                          = &asteroid->N;
+        }
+        else
+        {
+            // Comets are given the time of perihelion, where the mean anomaly is zero
+            const KSComet *comet = static_cast<const KSComet *>(m_Bodies[j]);
+            m_T0[j]              = double(comet->JDp - J2000);
+            m_M0[j]              = 0.0;
+            m_a[j]               = comet->a;
+            m_e[j]               = comet->e;
+            P                    = comet->P;
+            i                    = &comet->i;
+            w                    = &comet->w;
+            N                    = &comet->N;
+        }
+
+        m_n[j] = 2.0 * dms::PI / P;
+        m_b[j] = m_a[j] * sqrt(1.0 - m_e[j] * m_e[j]);
+
+        double sini, cosi, sinw, cosw, sinN, cosN;
+        i->SinCos(sini, cosi);
+        w->SinCos(sinw, cosw);
+        N->SinCos(sinN, cosN);
+
+        m_P[0][j] = cosN * cosw - sinN * sinw * cosi;
+        m_P[1][j] = sinN * cosw + cosN * sinw * cosi;
+        m_P[2][j] = sinw * sini;
+        m_Q[0][j] = -cosN * sinw - sinN * cosw * cosi;
+        m_Q[1][j] = -sinN * sinw + cosN * cosw * cosi;
+        m_Q[2][j] = cosw * sini;
+    }
+}
+
+void OrbitPropagator::solve(int begin, int end, double t)
+{
+    const double twoPi = 2.0 * dms::PI;
+    const double *e    = m_e.data();
+    double *M          = m_M.data();
+    double *E          = m_E.data();
+
+    // Mean anomaly brought to [-pi, pi), and a first approximation of the eccentric anomaly
+    for (int j = begin; j < end; ++j)
+    {
+        double m = m_M0[j] + m_n[j] * (t - m_T0[j]);
+        m -= twoPi * std::floor(m / twoPi + 0.5);
+        M[j] = m;
+        E[j] = m + e[j] * sin(m) * (1.0 + e[j] * cos(m));
+    }
+
+    // Newton's method on E - e sin E = M, for all the bodies of the chunk until the slowest converged
+    for (int iter = 0; iter < MAX_KEPLER_ITERATIONS; ++iter)
+    {
+        double maxStep = 0.0;
+        for (int j = begin; j < end; ++j)
+        {
+            const double step = (E[j] - e[j] * sin(E[j]) - M[j]) / (1.0 - e[j] * cos(E[j]));
+            E[j] -= step;
+            maxStep = std::max(maxStep, std::fabs(step));
+        }
+        if (maxStep < KEPLER_TOLERANCE)
+            break;
+    }
+
+    // Position in the plane of the orbit, rotated to the ecliptic
+    for (int j = begin; j < end; ++j)
+    {
+        const double x = m_a[j] * (cos(E[j]) - e[j]);
+        const double y = m_b[j] * sin(E[j]);
+        for (int k = 0; k < 3; ++k)
+            m_X[k][j] = x * m_P[k][j] + y * m_Q[k][j];
+    }
+}
+
+void OrbitPropagator::run(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST,
+                          const KSPlanetBase *Earth)
+{
+    if (m_Queue.isEmpty())
+        return;
+
+    // The same bodies are usually queued on every update
+    if (m_Queue != m_Bodies)
+        loadElements();
+    m_Queue.clear();
+
+    double earth[3];
+    if (Earth)
+    {
+        double sinL, cosL, sinB, cosB;
+        Earth->ecLong().SinCos(sinL, cosL);
+        Earth->ecLat().SinCos(sinB, cosB);
+        earth[0] = Earth->rsun() * cosB * cosL;
+        earth[1] = Earth->rsun() * cosB * sinL;
+        earth[2] = Earth->rsun() * sinB;
+    }
+    const double *earthPosition = Earth ? earth : nullptr;
+
+    const double t      = double(num->julianDay() - J2000);
+    const int count     = m_Bodies.size();
+    const int threads   = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    const int chunkSize = qMax(MIN_CHUNK_BODIES, count / (threads * CHUNKS_PER_THREAD) + 1);
+
+    // Bodies with a trail are finished afterwards, as adding to a trail is not thread-safe
+    auto process = [&](int begin)
+    {
+        const int end = qMin(begin + chunkSize, count);
+        solve(begin, end, t);
+        for (int j = begin; j < end; ++j)
+        {
+            if (m_Bodies[j]->hasTrail())
+                continue;
+            const double helio[3] = { m_X[0][j], m_X[1][j], m_X[2][j] };
+            m_Bodies[j]->setHeliocentricPosition(num, lat, LST, helio, earthPosition);
+        }
+    };
+
+    QVector<int> chunks;
+    for (int begin = 0; begin < count; begin += chunkSize)
+        chunks.append(begin);
+
+    if (chunks.size() == 1)
+        process(0);
+    else
+        QtConcurrent::blockingMap(chunks, process);
+
+    for (int j = 0; j < count; ++j)
+    {
+        if (m_Bodies[j]->hasTrail())
+        {
+            const double helio[3] = { m_X[0][j], m_X[1][j], m_X[2][j] };
+            m_Bodies[j]->setHeliocentricPosition(num, lat, LST, helio, earthPosition);
+        }
+    }
+}
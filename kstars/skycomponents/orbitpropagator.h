@@ -0,0 +1,81 @@
+/***************************************************************************
+                  orbitpropagator.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QVector>
+
+#include <vector>
+
+class CachingDms;
+class KSNumbers;
+class KSPlanetBase;
+
+/**
+ * @class OrbitPropagator
+ *
+ * Finds the positions of many asteroids and comets at once, from their orbital elements.
+ *
+ * The elements of the queued bodies are kept as a structure of arrays, and kept from one run to
+ * the next as long as the same bodies are queued. The Earth's position is computed once per run.
+ * Kepler's equation is solved in loops over the arrays that the compiler can vectorize, and the
+ * work is split in chunks over the global thread pool. The heliocentric positions are then handed
+ * to KSPlanetBase::setHeliocentricPosition(), which does the rest of what findPosition() does.
+ *
+ * Comets on near-parabolic orbits, and asteroids too faint to be calculated, are not handled and
+ * are left to findPosition().
+ *
+ * @short Batched orbit propagation of minor bodies
+ */
+class OrbitPropagator
+{
+  public:
+    /**
+     * @short Queue a body for the next run
+     * @return false if the body is not handled here, and must be positioned with findPosition()
+     */
+    bool addBody(KSPlanetBase *body);
+
+    /**
+     * @short Position all the queued bodies, and empty the queue
+     * @param num KSNumbers pointer for the target date/time
+     * @param lat pointer to the geographic latitude; if nullptr, the positions are geocentric
+     * @param LST pointer to the local sidereal time; if nullptr, the positions are geocentric
+     * @param Earth pointer to the Earth, already positioned for the target date/time
+     */
+    void run(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST, const KSPlanetBase *Earth);
+
+  private:
+    /** @short Copy the elements of the queued bodies into the arrays */
+    void loadElements();
+
+    /** @short Solve the orbits of bodies [begin, end) for time t, in days from J2000 */
+    void solve(int begin, int end, double t);
+
+    QVector<KSPlanetBase *> m_Queue;
+    // Bodies whose elements are in the arrays below
+    QVector<KSPlanetBase *> m_Bodies;
+
+    // Orbital elements: time of the mean anomaly M0 (days from J2000), mean motion (rad/day),
+    // semi-major axis (AU), eccentricity, semi-minor axis (AU), and the unit vectors towards the
+    // perihelion (P) and 90 degrees ahead of it in the orbit (Q), in ecliptic J2000 coordinates
+    std::vector<double> m_T0, m_M0, m_n, m_a, m_e, m_b;
+    std::vector<double> m_P[3], m_Q[3];
+
+    // Mean and eccentric anomalies, and the resulting heliocentric position in AU
+    std::vector<double> m_M, m_E;
+    std::vector<double> m_X[3];
+};
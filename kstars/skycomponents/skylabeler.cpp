@@ -25,6 +25,7 @@
 #include "Options.h"
 #include "kstarsdata.h" // MINZOOM
 #include "skymap.h"
+#include "skymapprofiler.h"
 #include "projections/projector.h"
 
 //---------------------------------------------------------------------------//
@@ -419,7 +420,9 @@ bool SkyLabeler::markText(const QPointF &p, const QString &text)
 {
     qreal maxX = p.x() + m_fontMetrics.width(text);
     qreal minY = p.y() - m_fontMetrics.height();
-    return markRegion(p.x(), maxX, p.y(), minY);
+    const bool placed = markRegion(p.x(), maxX, p.y(), minY);
+    SkyMapProfiler::count(placed ? SkyMapProfiler::LabelsPlaced : SkyMapProfiler::LabelsRejected);
+    return placed;
 }
 
 bool SkyLabeler::markRegion(qreal left, qreal right, qreal top, qreal bot)
@@ -41,6 +41,7 @@
 #include "milkyway.h"
 #include "satellitescomponent.h"
 #include "skylabeler.h"
+#include "skymapprofiler.h"
 #include "skypainter.h"
 #include "solarsystemcomposite.h"
 #include "starcomponent.h"
@@ -184,14 +185,21 @@ SkyMapComposite::SkyMapComposite(SkyComposite *parent) : SkyComposite(parent), m
 
 void SkyMapComposite::update(KSNumbers *num)
 {
+    // Times each component when the frame profiler is enabled
+    auto updateComponent = [num](SkyComponent *component, const char *name)
+    {
+        SkyMapProfiler::Scope scope(SkyMapProfiler::Update, name);
+        component->update(num);
+    };
+
     //printf("updating SkyMapComposite\n");
     //1. Milky Way
     //m_MilkyWay->update( data, num );
     //2. Coordinate grid
     //m_EquatorialCoordinateGrid->update( num );
-    m_HorizontalCoordinateGrid->update(num);
+    updateComponent(m_HorizontalCoordinateGrid, "HorizontalCoordinateGrid");
 #ifndef KSTARS_LITE
-    m_LocalMeridianComponent->update(num);
+    updateComponent(m_LocalMeridianComponent, "LocalMeridian");
 #endif
     //3. Constellation boundaries
     //m_CBounds->update( data, num );
@@ -199,7 +207,7 @@ void SkyMapComposite::update(KSNumbers *num)
     //m_CLines->update( data, num );
     //5. Constellation names
     if (m_CNames)
-        m_CNames->update(num);
+        updateComponent(m_CNames, "ConstellationNames");
     //6. Equator
     //m_Equator->update( data, num );
     //7. Ecliptic
@@ -207,35 +215,37 @@ void SkyMapComposite::update(KSNumbers *num)
     //8. Deep sky
     //m_DeepSky->update( data, num );
     //9. Custom catalogs
-    m_CustomCatalogs->update(num);
-    m_internetResolvedComponent->update(num);
-    m_manualAdditionsComponent->update(num);
+    updateComponent(m_CustomCatalogs.get(), "CustomCatalogs");
+    updateComponent(m_internetResolvedComponent, "InternetResolved");
+    updateComponent(m_manualAdditionsComponent, "ManualAdditions");
     //10. Stars
     //m_Stars->update( data, num );
     //m_CLines->update( data, num );  // MUST follow stars.
 
     //12. Solar system
-    m_SolarSystem->update(num);
+    updateComponent(m_SolarSystem, "SolarSystem");
     //13. Satellites
-    m_Satellites->update(num);
+    updateComponent(m_Satellites, "Satellites");
     //14. Supernovae
-    m_Supernovae->update(num);
+    updateComponent(m_Supernovae, "Supernovae");
     //15. Horizon
-    m_Horizon->update(num);
+    updateComponent(m_Horizon, "Horizon");
 #ifndef KSTARS_LITE
     //16. Flags
-    m_Flags->update(num);
+    updateComponent(m_Flags, "Flags");
 #endif
 }
 
 void SkyMapComposite::updateSolarSystemBodies(KSNumbers *num)
 {
+    SkyMapProfiler::Scope scope(SkyMapProfiler::Update, "SolarSystemBodies");
     m_SolarSystem->updateSolarSystemBodies(num);
 }
 
 
 void SkyMapComposite::updateMoons(KSNumbers *num )
 {
+    SkyMapProfiler::Scope scope(SkyMapProfiler::Update, "Moons");
     m_SolarSystem->updateMoons( num );
 }
 
@@ -311,66 +321,80 @@ void SkyMapComposite::draw(SkyPainter *skyp)
             }
     }
 
-    m_MilkyWay->draw(skyp);
+    // Times each layer when the frame profiler is enabled
+    auto drawComponent = [skyp](SkyComponent *component, const char *name)
+    {
+        SkyMapProfiler::Scope scope(SkyMapProfiler::Draw, name);
+        component->draw(skyp);
+    };
+
+    drawComponent(m_MilkyWay, "MilkyWay");
 
     // Draw HIPS after milky way but before everything else
-    m_HiPS->draw(skyp);
+    drawComponent(m_HiPS, "HiPS");
 
-    m_EquatorialCoordinateGrid->draw(skyp);
-    m_HorizontalCoordinateGrid->draw(skyp);
-    m_LocalMeridianComponent->draw(skyp);
+    drawComponent(m_EquatorialCoordinateGrid, "EquatorialCoordinateGrid");
+    drawComponent(m_HorizontalCoordinateGrid, "HorizontalCoordinateGrid");
+    drawComponent(m_LocalMeridianComponent, "LocalMeridian");
 
     //Draw constellation boundary lines only if we draw western constellations
     if (m_Cultures->current() == "Western")
     {
-        m_CBoundLines->draw(skyp);
-        m_ConstellationArt->draw(skyp);
+        drawComponent(m_CBoundLines, "ConstellationBoundaries");
+        drawComponent(m_ConstellationArt, "ConstellationArt");
     }
     else if (m_Cultures->current() == "Inuit")
     {
-        m_ConstellationArt->draw(skyp);
+        drawComponent(m_ConstellationArt, "ConstellationArt");
     }
 
-    m_CLines->draw(skyp);
+    drawComponent(m_CLines, "ConstellationLines");
 
-    m_Equator->draw(skyp);
+    drawComponent(m_Equator, "Equator");
 
-    m_Ecliptic->draw(skyp);
+    drawComponent(m_Ecliptic, "Ecliptic");
 
-    m_DeepSky->draw(skyp);
+    drawComponent(m_DeepSky, "DeepSky");
 
-    m_CustomCatalogs->draw(skyp);
-    m_internetResolvedComponent->draw(skyp);
-    m_manualAdditionsComponent->draw(skyp);
+    drawComponent(m_CustomCatalogs.get(), "CustomCatalogs");
+    drawComponent(m_internetResolvedComponent, "InternetResolved");
+    drawComponent(m_manualAdditionsComponent, "ManualAdditions");
 
-    m_Stars->draw(skyp);
+    drawComponent(m_Stars, "Stars");
 
-    m_SolarSystem->drawTrails(skyp);
-    m_SolarSystem->draw(skyp);
+    {
+        SkyMapProfiler::Scope scope(SkyMapProfiler::Draw, "Trails");
+        m_SolarSystem->drawTrails(skyp);
+    }
+    drawComponent(m_SolarSystem, "SolarSystem");
 
-    m_Satellites->draw(skyp);
+    drawComponent(m_Satellites, "Satellites");
 
-    m_Supernovae->draw(skyp);
+    drawComponent(m_Supernovae, "Supernovae");
 
-    map->drawObjectLabels(labelObjects());
+    // Labels are placed last, in a single pass
+    {
+        SkyMapProfiler::Scope scope(SkyMapProfiler::Draw, "Labels");
+        map->drawObjectLabels(labelObjects());
 
-    m_skyLabeler->drawQueuedLabels();
-    m_CNames->draw(skyp);
-    m_Stars->drawLabels();
-    m_DeepSky->drawLabels();
+        m_skyLabeler->drawQueuedLabels();
+        m_CNames->draw(skyp);
+        m_Stars->drawLabels();
+        m_DeepSky->drawLabels();
+    }
 
     m_ObservingList->pen = QPen(QColor(data->colorScheme()->colorNamed("ObsListColor")), 1.);
     m_ObservingList->list2 = KStarsData::Instance()->observingList()->sessionList();
-    m_ObservingList->draw(skyp);
+    drawComponent(m_ObservingList, "ObservingList");
 
-    m_Flags->draw(skyp);
+    drawComponent(m_Flags, "Flags");
 
     m_StarHopRouteList->pen = QPen(QColor(data->colorScheme()->colorNamed("StarHopRouteColor")), 1.);
-    m_StarHopRouteList->draw(skyp);
+    drawComponent(m_StarHopRouteList, "StarHopRoute");
 
-    m_ArtificialHorizon->draw(skyp);
+    drawComponent(m_ArtificialHorizon, "ArtificialHorizon");
 
-    m_Horizon->draw(skyp);
+    drawComponent(m_Horizon, "Horizon");
 
     m_skyMesh->inDraw(false);
 
@@ -583,6 +607,21 @@ QList<SkyObject *> SkyMapComposite::findObjectsInArea(const SkyPoint &p1, const
     return list;
 }
 
+QList<SkyObject *> SkyMapComposite::findObjectsInArea(const QList<SkyPoint> &polygon)
+{
+    SkyList points;
+    for (const SkyPoint &vertex : polygon)
+        points.append(std::make_shared<SkyPoint>(vertex));
+
+    const SkyRegion &region = m_skyMesh->indexPoly(&points);
+    QList<SkyObject *> list;
+    if (m_Stars->selected())
+        m_Stars->objectsInArea(list, region);
+    if (m_DeepSky->selected())
+        m_DeepSky->objectsInArea(list, region);
+    return list;
+}
+
 SkyObject *SkyMapComposite::findByName(const QString &name)
 {
 #ifndef KSTARS_LITE
@@ -161,6 +161,12 @@ class SkyMapComposite : public QObject, public SkyComposite
      */
     QList<SkyObject *> findObjectsInArea(const SkyPoint &p1, const SkyPoint &p2);
 
+    /**
+     * @return the list of objects in the region defined by a polygon
+     * @param polygon vertices of a convex polygon smaller than a hemisphere, in J2000 coordinates
+     */
+    QList<SkyObject *> findObjectsInArea(const QList<SkyPoint> &polygon);
+
     void addCustomCatalog(const QString &filename, int index);
     void removeCustomCatalog(const QString &name);
 
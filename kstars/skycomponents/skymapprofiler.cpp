@@ -0,0 +1,157 @@
+/***************************************************************************
+                 skymapprofiler.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "skymapprofiler.h"
+
+#include "kspaths.h"
+#include "Options.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <algorithm>
+
+#include <kstars_debug.h>
+
+namespace
+{
+const char *const counterNames[SkyMapProfiler::NumCounters] = { "StarsDrawn",      "TrixelsVisited", "StarBlockHits",
+                                                                "StarBlockMisses", "LabelsPlaced",   "LabelsRejected" };
+
+const char *const csvHeader = "frame,timestamp,phase,component,value\n";
+}
+
+bool SkyMapProfiler::m_Enabled            = false;
+SkyMapProfiler *SkyMapProfiler::pInstance = nullptr;
+
+SkyMapProfiler *SkyMapProfiler::Instance()
+{
+    if (!pInstance)
+        pInstance = new SkyMapProfiler();
+    return pInstance;
+}
+
+SkyMapProfiler::SkyMapProfiler()
+{
+    m_Enabled = Options::frameProfiler();
+}
+
+void SkyMapProfiler::setEnabled(bool enable)
+{
+    Options::setFrameProfiler(enable);
+
+    if (enable == m_Enabled)
+        return;
+
+    m_Enabled = enable;
+    m_Timings.clear();
+    std::fill(m_Counters, m_Counters + NumCounters, 0);
+    m_FrameTimer.invalidate();
+
+    if (enable)
+        qCInfo(KSTARS) << "Sky map frame profiler enabled, logging to" << logFileName();
+    else
+    {
+        m_Log.close();
+        qCInfo(KSTARS) << "Sky map frame profiler disabled";
+    }
+}
+
+void SkyMapProfiler::addTime(Phase phase, const char *component, qint64 nsecs)
+{
+    if (!m_Enabled)
+        return;
+
+    // Few components per frame, a linear search is fine
+    for (Timing &timing : m_Timings)
+    {
+        if (timing.phase == phase && timing.component == component)
+        {
+            timing.nsecs += nsecs;
+            return;
+        }
+    }
+    m_Timings.append({ phase, component, nsecs });
+}
+
+void SkyMapProfiler::beginFrame()
+{
+    if (m_Enabled)
+        m_FrameTimer.start();
+}
+
+void SkyMapProfiler::endFrame()
+{
+    if (!m_Enabled || !m_FrameTimer.isValid())
+        return;
+
+    const qint64 frameTime = m_FrameTimer.nsecsElapsed();
+    m_FrameTimer.invalidate();
+
+    const QString prefix = QString("%1,%2,").arg(m_Frame++).arg(QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd'T'HH:mm:ss.zzz"));
+
+    QString rows;
+    QTextStream out(&rows);
+    for (const Timing &timing : m_Timings)
+        out << prefix << (timing.phase == Update ? "update," : "draw,") << timing.component << ',' << timing.nsecs / 1000 << '\n';
+    for (int i = 0; i < NumCounters; ++i)
+        out << prefix << "counter," << counterNames[i] << ',' << m_Counters[i] << '\n';
+    out << prefix << "frame,SkyMap," << frameTime / 1000 << '\n';
+    out.flush();
+
+    m_LastFrame = csvHeader + rows;
+    writeLog(rows);
+
+    m_Timings.clear();
+    std::fill(m_Counters, m_Counters + NumCounters, 0);
+}
+
+QString SkyMapProfiler::logFileName() const
+{
+    return KSPaths::writableLocation(QStandardPaths::GenericDataLocation) + "logs/frameprofile.csv";
+}
+
+void SkyMapProfiler::writeLog(const QString &rows)
+{
+    const qint64 maxSize = qint64(Options::frameProfilerLogSize()) * 1024 * 1024;
+
+    // Keep one previous log around, so that the log never grows beyond twice the limit
+    if (m_Log.isOpen() && m_Log.size() > maxSize)
+    {
+        m_Log.close();
+        QFile::remove(m_Log.fileName() + ".1");
+        QFile::rename(m_Log.fileName(), m_Log.fileName() + ".1");
+    }
+
+    if (!m_Log.isOpen())
+    {
+        const QString fileName = logFileName();
+        QDir().mkpath(QFileInfo(fileName).absolutePath());
+        m_Log.setFileName(fileName);
+        if (!m_Log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+        {
+            qCWarning(KSTARS) << "Cannot open frame profiler log" << fileName << ":" << m_Log.errorString();
+            return;
+        }
+        if (m_Log.size() == 0)
+            m_Log.write(csvHeader);
+    }
+
+    m_Log.write(rows.toUtf8());
+    m_Log.flush();
+}
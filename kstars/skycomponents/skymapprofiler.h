@@ -0,0 +1,136 @@
+/***************************************************************************
+                  skymapprofiler.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class SkyMapProfiler
+ *
+ * Per-frame timing and counters of the sky map, switched on and off at run time.
+ *
+ * While enabled, the time spent updating and drawing each sky component is accumulated into
+ * the current frame, together with a few counters: stars drawn, trixels visited, star block
+ * cache hits and misses, and labels placed or rejected. Updates done between two paint events
+ * are accounted to the next frame. endFrame() closes the frame at the end of the sky map paint
+ * event and appends it to a rolling CSV log; the last frame is also available over D-Bus.
+ *
+ * When disabled, each instrumentation point costs the test of a static flag.
+ * @note Must only be used from the GUI thread.
+ *
+ * @short Runtime profiler of sky map frames
+ */
+class SkyMapProfiler
+{
+  public:
+    enum Phase
+    {
+        Update,
+        Draw
+    };
+
+    enum Counter
+    {
+        StarsDrawn,
+        TrixelsVisited,
+        StarBlockHits,
+        StarBlockMisses,
+        LabelsPlaced,
+        LabelsRejected,
+        NumCounters
+    };
+
+    /**
+     * @short Times the enclosing scope and accounts it to a component
+     * @note The component name must be a string literal, or outlive the frame
+     */
+    class Scope
+    {
+      public:
+        Scope(Phase phase, const char *component) : m_Phase(phase), m_Component(component)
+        {
+            if (m_Enabled)
+                m_Timer.start();
+        }
+        ~Scope()
+        {
+            if (m_Timer.isValid())
+                Instance()->addTime(m_Phase, m_Component, m_Timer.nsecsElapsed());
+        }
+
+      private:
+        Phase m_Phase;
+        const char *m_Component;
+        QElapsedTimer m_Timer;
+    };
+
+    static SkyMapProfiler *Instance();
+
+    /** @return true if frames are being profiled */
+    static inline bool isEnabled() { return m_Enabled; }
+
+    /** @short Start or stop profiling, and remember the choice in the options */
+    void setEnabled(bool enable);
+
+    /** @short Add to a counter of the current frame */
+    static inline void count(Counter counter, qint64 n = 1)
+    {
+        if (m_Enabled)
+            Instance()->m_Counters[counter] += n;
+    }
+
+    /** @short Account time spent in a component to the current frame */
+    void addTime(Phase phase, const char *component, qint64 nsecs);
+
+    /** @short Mark the start of a sky map redraw */
+    void beginFrame();
+
+    /** @short Close the current frame, and append it to the log */
+    void endFrame();
+
+    /** @return the last frame as CSV, header included, or an empty string if none was profiled */
+    inline const QString &lastFrame() const { return m_LastFrame; }
+
+    /** @return the path of the CSV log */
+    QString logFileName() const;
+
+  private:
+    SkyMapProfiler();
+
+    /** @short Append rows to the log, moving the log aside when it grows too large */
+    void writeLog(const QString &rows);
+
+    struct Timing
+    {
+        Phase phase;
+        const char *component;
+        qint64 nsecs;
+    };
+
+    QVector<Timing> m_Timings;
+    qint64 m_Counters[NumCounters] {};
+    QElapsedTimer m_FrameTimer;
+    quint64 m_Frame { 0 };
+    QString m_LastFrame;
+    QFile m_Log;
+
+    static bool m_Enabled;
+    static SkyMapProfiler *pInstance;
+};
@@ -45,13 +45,16 @@ void SolarSystemListComponent::update(KSNumbers *)
     {
         KStarsData *data = KStarsData::Instance();
 
+        QVector<SkyPoint *> points;
+        points.reserve(m_ObjectList.size());
         foreach (SkyObject *o, m_ObjectList)
         {
             KSPlanetBase *p = dynamic_cast<KSPlanetBase*>(o);
 
             if (p)
-                p->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+                points.append(p);
         }
+        SkyPoint::EquatorialToHorizontal(points.constData(), points.size(), data->lst(), data->geo()->lat());
     }
 }
 
@@ -60,12 +63,23 @@ void SolarSystemListComponent::updateSolarSystemBodies(KSNumbers *num)
     if (selected())
     {
         KStarsData *data = KStarsData::Instance();
+
+        // Asteroids and comets are positioned in bulk, whatever the propagator does not handle one by one
+        QVector<SkyPoint *> points;
+        points.reserve(m_ObjectList.size());
         foreach (SkyObject *o, m_ObjectList)
         {
             KSPlanetBase *p = (KSPlanetBase *)o;
-            p->findPosition(num, data->geo()->lat(), data->lst(), m_Earth);
-            p->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+            if (!m_Propagator.addBody(p))
+                p->findPosition(num, data->geo()->lat(), data->lst(), m_Earth);
+            points.append(p);
+        }
+        m_Propagator.run(num, data->geo()->lat(), data->lst(), m_Earth);
+        SkyPoint::EquatorialToHorizontal(points.constData(), points.size(), data->lst(), data->geo()->lat());
 
+        foreach (SkyObject *o, m_ObjectList)
+        {
+            KSPlanetBase *p = (KSPlanetBase *)o;
             if (p->hasTrail())
                 p->updateTrail(data->lst(), data->geo()->lat());
         }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "listcomponent.h"
+#include "orbitpropagator.h"
 
 class KSPlanet;
 class SolarSystemComposite;
@@ -51,4 +52,5 @@ class SolarSystemListComponent : public ListComponent
 
   private:
     KSPlanet *m_Earth { nullptr };
+    OrbitPropagator m_Propagator;
 };
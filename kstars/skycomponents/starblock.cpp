@@ -23,6 +23,13 @@
 #include "skyobjects/stardata.h"
 #include "skyobjects/deepstardata.h"
 
+#ifndef KSTARS_LITE
+#include "kstarsdata.h"
+#include "Options.h"
+
+#include <ctime>
+#endif
+
 #ifdef KSTARS_LITE
 #include "skymaplite.h"
 #include "kstarslite/skyitems/skynodes/pointsourcenode.h"
@@ -46,7 +53,8 @@ StarBlock::StarBlock(int nstars)
 #ifdef KSTARS_LITE
       stars(nstars, StarNode())
 #else
-      stars(nstars, StarObject())
+      stars(nstars, StarObject()), m_Position0(3, nstars), m_PMDirection(3, nstars), m_PMRate(nstars),
+      m_Magnitudes(nstars)
 #endif
 {
 }
@@ -104,6 +112,7 @@ StarObject *StarBlock::addStar(const StarData &data)
         faintMag = star.mag();
     if (star.mag() < brightMag)
         brightMag = star.mag();
+    updateArrays(nStars - 1);
     return &star;
 }
 
@@ -118,6 +127,161 @@ StarObject *StarBlock::addStar(const DeepStarData &data)
         faintMag = star.mag();
     if (star.mag() < brightMag)
         brightMag = star.mag();
+    updateArrays(nStars - 1);
     return &star;
 }
+
+void StarBlock::updateArrays(int i)
+{
+    const StarObject &star = stars[i];
+    double sinRA, cosRA, sinDec, cosDec;
+
+    star.ra0().SinCos(sinRA, cosRA);
+    star.dec0().SinCos(sinDec, cosDec);
+
+    m_Position0.col(i) << cosRA * cosDec, sinRA * cosDec, sinDec;
+    m_Magnitudes[i] = star.mag();
+
+    // The proper motion moves the star along the great circle of bearing atan2(pmRA, pmDec), by
+    // pmMagnitude() milliarcseconds per year, i.e. arcseconds per millennium. See StarObject::getIndexCoords()
+    double pmNorm = sqrt(star.pmRA() * star.pmRA() + star.pmDec() * star.pmDec());
+    double pm     = star.pmMagnitude();
+    if (std::isnan(pm) || pmNorm == 0.)
+    {
+        m_PMDirection.col(i).setZero();
+        m_PMRate[i] = 0.;
+        return;
+    }
+
+    // East and north unit vectors at the catalog position
+    Eigen::Vector3d east(-sinRA, cosRA, 0.);
+    Eigen::Vector3d north(-sinDec * cosRA, -sinDec * sinRA, cosDec);
+
+    m_PMDirection.col(i) = (star.pmRA() * east + star.pmDec() * north) / pmNorm;
+    m_PMRate[i]          = pm * dms::DegToRad / 3600.0;
+}
+
+void StarBlock::JITupdate(float maglim)
+{
+    static KStarsData *data = KStarsData::Instance();
+    const KSNumbers *num    = data->updateNum();
+
+    // Update up to and including the first star fainter than maglim, like the per-star loops used to
+    int n = 0;
+    while (n < nStars && m_Magnitudes[n] <= maglim)
+        ++n;
+    if (n < nStars)
+        ++n;
+
+    // Light bending depends on the position of each star relative to the Sun; leave that to the per-star path
+    if (Options::useRelativistic())
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            if (stars[i].updateID != data->updateID())
+                stars[i].JITupdate();
+        }
+        return;
+    }
+
+    // Same short-circuit as in StarObject::JITupdate(): coordinates are recomputed once per solar minute
+    const double jd     = num->getJD();
+    const bool always   = Options::alwaysRecomputeCoordinates();
+    bool recompute      = false;
+    for (int i = 0; i < n && !recompute; ++i)
+    {
+        const StarObject &star = stars[i];
+        recompute = star.updateNumID != data->updateNumID() &&
+                    (always || std::abs(star.getLastPrecessJD() - jd) >= 0.00069444);
+    }
+
+    if (recompute)
+    {
+#ifdef PROFILE_UPDATECOORDS
+        std::clock_t start = std::clock();
+#endif
+        // Proper motion, as a rotation of the catalog position along the direction of motion.
+        // Corrections under an arcsecond are ignored, as in StarObject::getIndexCoords()
+        Eigen::Array<double, 1, Eigen::Dynamic> pmAngle = m_PMRate.head(n) * num->julianMillenia();
+        pmAngle = (pmAngle.abs() < dms::DegToRad / 3600.0).select(0., pmAngle);
+        const Eigen::Array<double, 1, Eigen::Dynamic> cosPM = pmAngle.cos(), sinPM = pmAngle.sin();
+
+        Eigen::Matrix3Xd position(3, n);
+        position.array() = m_Position0.leftCols(n).array().rowwise() * cosPM +
+                           m_PMDirection.leftCols(n).array().rowwise() * sinPM;
+
+        // Precession of the whole block with a single matrix product, see SkyPoint::precess()
+        const Eigen::Matrix3Xd precessed = num->p2() * position;
+
+        double sinOb, cosOb, sinL, cosL, sinP, cosP;
+        num->obliquity()->SinCos(sinOb, cosOb);
+        num->sunTrueLongitude().SinCos(sinL, cosL);
+        num->earthPerihelionLongitude().SinCos(sinP, cosP);
+
+        const double dEcLong = num->dEcLong() * dms::DegToRad;
+        const double dObliq  = num->dObliq() * dms::DegToRad;
+        const double K       = num->constAberr().radians();
+        const double e       = num->earthEccentricity();
+        const double cos80   = cos(80.0 * dms::DegToRad);
+
+        for (int i = 0; i < n; ++i)
+        {
+            StarObject &star = stars[i];
+            if (star.updateNumID == data->updateNumID() ||
+                    (!always && std::abs(star.getLastPrecessJD() - jd) < 0.00069444))
+                continue;
+
+            const double x = precessed(0, i), y = precessed(1, i);
+            double sinDec  = precessed(2, i);
+            double cosDec  = sqrt(x * x + y * y);
+
+            // SkyPoint::nutate() switches to the exact method near the poles, so do these stars one by one
+            if (cosDec < cos80)
+            {
+                star.updateCoords(num);
+                continue;
+            }
+
+            double sinRA = y / cosDec, cosRA = x / cosDec;
+
+            // Nutation and aberration are shifts of at most a few tens of arcseconds, so the sine and cosine
+            // of the shifted angles are updated to first order instead of being recomputed
+            double tanDec = sinDec / cosDec;
+            double dRA    = dEcLong * (cosOb + sinOb * sinRA * tanDec) - dObliq * cosRA * tanDec;
+            double dDec   = dEcLong * (sinOb * cosRA) + dObliq * sinRA;
+            double s      = sinRA;
+            sinRA += cosRA * dRA;
+            cosRA -= s * dRA;
+            s = sinDec;
+            sinDec += cosDec * dDec;
+            cosDec -= s * dDec;
+
+            // Aberration, as in SkyPoint::aberrate()
+            dRA  = K * (cosRA * cosOb / cosDec) * (e * cosP - cosL);
+            dDec = K * (sinRA * (sinOb * cosDec - cosOb * sinDec) * (e * cosP - cosL) +
+                        cosRA * sinDec * (e * sinP - sinL));
+            s = sinRA;
+            sinRA += cosRA * dRA;
+            cosRA -= s * dRA;
+            sinDec += cosDec * dDec;
+
+            star.setUpdatedCoords(sinRA, cosRA, sinDec, jd);
+        }
+#ifdef PROFILE_UPDATECOORDS
+        StarObject::updateCoordsCpuTime += double(std::clock() - start) / double(CLOCKS_PER_SEC);
+        StarObject::starsUpdated += n;
+#endif
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        StarObject &star = stars[i];
+        star.updateNumID = data->updateNumID();
+        if (star.updateID != data->updateID())
+        {
+            star.EquatorialToHorizontal(data->lst(), data->geo()->lat());
+            star.updateID = data->updateID();
+        }
+    }
+}
 #endif
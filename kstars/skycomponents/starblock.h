@@ -22,6 +22,10 @@
 
 #include <QVector>
 
+#ifndef KSTARS_LITE
+#include <Eigen/Core>
+#endif
+
 class StarObject;
 class StarBlockList;
 class PointSourceNode;
@@ -143,6 +147,20 @@ class StarBlock
     /** @short  Reset this StarBlock's data, for reuse of the StarBlock */
     void reset();
 
+#ifndef KSTARS_LITE
+    /**
+     * @short  Update the coordinates of the stars in this StarBlock for the current time
+     *
+     * Batched equivalent of calling StarObject::JITupdate() on the stars of this block, in order,
+     * up to and including the first star fainter than maglim. Proper motion, precession, nutation
+     * and aberration are computed for the whole block at once from a structure-of-arrays copy of
+     * the catalog data, and only the resulting RA / Dec are written back to the StarObjects.
+     *
+     * @param  maglim  Magnitude limit of the stars to update
+     */
+    void JITupdate(float maglim);
+#endif
+
     float faintMag { 0 };
     float brightMag { 0 };
     StarBlockList *parent;
@@ -155,8 +173,24 @@ class StarBlock
     StarBlock(const StarBlock &);
     StarBlock &operator=(const StarBlock &);
 
+#ifndef KSTARS_LITE
+    /** @short Fill the structure-of-arrays entries of the i-th star from its catalog data */
+    void updateArrays(int i);
+#endif
+
     /** Number of initialized stars in StarBlock. */
     int nStars { 0 };
     /** Array of stars. */
     QVector<StarBlockEntry> stars;
+
+#ifndef KSTARS_LITE
+    /** Unit vectors of the J2000 catalog positions, one column per star */
+    Eigen::Matrix3Xd m_Position0;
+    /** Unit vectors tangent to m_Position0 in the direction of the proper motion */
+    Eigen::Matrix3Xd m_PMDirection;
+    /** Proper motion in radians per Julian millennium */
+    Eigen::Array<double, 1, Eigen::Dynamic> m_PMRate;
+    /** Magnitudes of the stars */
+    QVector<float> m_Magnitudes;
+#endif
 };
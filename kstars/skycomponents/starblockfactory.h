@@ -19,6 +19,8 @@
 
 #include "typedef.h"
 
+#include <QMutex>
+
 class StarBlock;
 
 /**
@@ -94,6 +96,16 @@ class StarBlockFactory
      */
     void printStructure() const;
 
+    /**
+     * @short  Returns the mutex guarding the cache
+     *
+     * Blocks are recycled from one StarBlockList to another, so this mutex guards both the
+     * LRU list of the factory and the contents of all dynamically loaded StarBlockLists.
+     * It must be held while filling, marking or reading dynamically loaded blocks whenever
+     * the StarBlockLoader thread may be running.
+     */
+    inline QMutex &mutex() { return m_Mutex; }
+
     quint32 drawID; // A number identifying the current draw cycle
 
   private:
@@ -114,6 +126,7 @@ class StarBlockFactory
     std::shared_ptr<StarBlock> first, last; // Pointers to the beginning and end of the linked list
     int nBlocks;             // Number of blocks we currently have in the cache
     int nCache;              // Number of blocks to start recycling cached blocks at
+    QMutex m_Mutex;          // Guards the cache, see mutex()
 
     static StarBlockFactory *pInstance;
 };
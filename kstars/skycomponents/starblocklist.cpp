@@ -103,7 +103,15 @@ bool StarBlockList::fillToMag(float maglim)
 
     Q_ASSERT(nBlocks == (unsigned int)blocks.size());
 
-    BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
+    // Memory mapped catalogs are read in place, without seeking the shared file handle.
+    // Unless they need byte swapping, their records are even added straight from the mapping.
+    bool mapped = dSReader->isMapped();
+    bool byteSwap = dSReader->getByteSwap();
+    const StarData *starRecords = (mapped && !byteSwap) ? dSReader->mappedRecords<StarData>(trixelId) : nullptr;
+    const DeepStarData *deepStarRecords =
+        (mapped && !byteSwap) ? dSReader->mappedRecords<DeepStarData>(trixelId) : nullptr;
+    if (!mapped)
+        BinFileHelper::unsigned_KDE_fseek(dataFile, readOffset, SEEK_SET);
 
     /*
     qDebug() << "Reading trixel" << trixel << ", id on disk =" << trixelId << ", currently nStars =" << nStars
@@ -137,19 +145,35 @@ bool StarBlockList::fillToMag(float maglim)
         // TODO: Make this more general
         if (dSReader->guessRecordSize() == 32)
         {
-            ret = fread(&stardata, sizeof(StarData), 1, dataFile);
-            if (dSReader->getByteSwap())
-                DeepStarComponent::byteSwap(&stardata);
+            if (starRecords)
+                blocks[nBlocks - 1]->addStar(starRecords[nStars]);
+            else
+            {
+                if (mapped)
+                    ret = dSReader->readMappedRecord(readOffset, &stardata);
+                else
+                    ret = fread(&stardata, sizeof(StarData), 1, dataFile);
+                if (byteSwap)
+                    DeepStarComponent::byteSwap(&stardata);
+                blocks[nBlocks - 1]->addStar(stardata);
+            }
             readOffset += sizeof(StarData);
-            blocks[nBlocks - 1]->addStar(stardata);
         }
         else
         {
-            ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
-            if (dSReader->getByteSwap())
-                DeepStarComponent::byteSwap(&deepstardata);
+            if (deepStarRecords)
+                blocks[nBlocks - 1]->addStar(deepStarRecords[nStars]);
+            else
+            {
+                if (mapped)
+                    ret = dSReader->readMappedRecord(readOffset, &deepstardata);
+                else
+                    ret = fread(&deepstardata, sizeof(DeepStarData), 1, dataFile);
+                if (byteSwap)
+                    DeepStarComponent::byteSwap(&deepstardata);
+                blocks[nBlocks - 1]->addStar(deepstardata);
+            }
             readOffset += sizeof(DeepStarData);
-            blocks[nBlocks - 1]->addStar(deepstardata);
         }
 
         /*
@@ -165,6 +189,20 @@ bool StarBlockList::fillToMag(float maglim)
     return ((maglim < faintMag) ? true : false);
 }
 
+long StarBlockList::nextRecordOffset() const
+{
+    return (readOffset > 0) ? readOffset : parent->getStarReader()->getOffset(trixel);
+}
+
+unsigned long StarBlockList::pendingRecordCount() const
+{
+    if (staticStars)
+        return 0;
+
+    unsigned long records = parent->getStarReader()->getRecordCount(trixel);
+    return (records > nStars) ? records - nStars : 0;
+}
+
 void StarBlockList::setStaticBlock(std::shared_ptr<StarBlock> &block)
 {
     if (!block)
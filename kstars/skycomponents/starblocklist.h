@@ -97,6 +97,18 @@ class StarBlockList
      */
     inline float getFaintMag() const { return faintMag; }
 
+    /**
+     * @short  Returns the offset in the data file of the next record fillToMag() would read
+     * @return Offset of the first record not yet loaded into this StarBlockList
+     */
+    long nextRecordOffset() const;
+
+    /**
+     * @short  Returns the number of records of this trixel that have not been loaded yet
+     * @return Number of records in the data file that fillToMag() may still read
+     */
+    unsigned long pendingRecordCount() const;
+
     /**
      * @short  Returns the trixel that this SBL is meant for
      * @return The value of trixel
@@ -0,0 +1,160 @@
+/***************************************************************************
+                 starblockloader.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "starblockloader.h"
+
+#include "binfilehelper.h"
+#include "deepstarcomponent.h"
+#include "starblockfactory.h"
+#include "starblocklist.h"
+
+#include <kstars_debug.h>
+
+StarBlockLoader *StarBlockLoader::pInstance = nullptr;
+
+StarBlockLoader *StarBlockLoader::Instance()
+{
+    if (!pInstance)
+    {
+        pInstance = new StarBlockLoader();
+        pInstance->start(QThread::LowPriority);
+    }
+    return pInstance;
+}
+
+void StarBlockLoader::Release()
+{
+    delete pInstance;
+    pInstance = nullptr;
+}
+
+StarBlockLoader::StarBlockLoader()
+{
+    setObjectName("StarBlockLoader");
+}
+
+StarBlockLoader::~StarBlockLoader()
+{
+    {
+        QMutexLocker locker(&m_QueueMutex);
+        m_Abort = true;
+        m_Queue.clear();
+        m_QueueCondition.wakeAll();
+    }
+    wait();
+}
+
+void StarBlockLoader::request(DeepStarComponent *component, const QVector<Trixel> &trixels, float maglim)
+{
+    QMutexLocker locker(&m_QueueMutex);
+
+    for (auto it = m_Queue.begin(); it != m_Queue.end();)
+    {
+        if (it->component == component)
+            it = m_Queue.erase(it);
+        else
+            ++it;
+    }
+
+    for (Trixel trixel : trixels)
+        m_Queue.append({ component, trixel, maglim });
+
+    if (!m_Queue.isEmpty())
+        m_QueueCondition.wakeOne();
+}
+
+void StarBlockLoader::cancel(DeepStarComponent *component)
+{
+    QMutexLocker locker(&m_QueueMutex);
+
+    for (auto it = m_Queue.begin(); it != m_Queue.end();)
+    {
+        if (it->component == component)
+            it = m_Queue.erase(it);
+        else
+            ++it;
+    }
+
+    while (m_Current == component)
+        m_IdleCondition.wait(&m_QueueMutex);
+}
+
+void StarBlockLoader::run()
+{
+    bool loaded = false;
+
+    forever
+    {
+        Request next;
+        {
+            QMutexLocker locker(&m_QueueMutex);
+            m_Current = nullptr;
+            m_IdleCondition.wakeAll();
+
+            // Only ask for a repaint once everything that was requested is in memory
+            if (m_Queue.isEmpty() && loaded)
+            {
+                loaded = false;
+                emit blocksLoaded();
+            }
+
+            while (m_Queue.isEmpty() && !m_Abort)
+                m_QueueCondition.wait(&m_QueueMutex);
+
+            if (m_Abort)
+                return;
+
+            next      = m_Queue.takeFirst();
+            m_Current = next.component;
+        }
+
+        if (load(next))
+            loaded = true;
+    }
+}
+
+bool StarBlockLoader::load(const Request &request)
+{
+    std::shared_ptr<StarBlockList> sbl = request.component->starBlockList(request.trixel);
+    if (!sbl)
+        return false;
+
+    StarBlockFactory *factory = StarBlockFactory::Instance();
+    BinFileHelper *reader     = request.component->getStarReader();
+    long offset               = 0;
+    unsigned long pending     = 0;
+
+    {
+        QMutexLocker locker(&factory->mutex());
+        if (sbl->getFaintMag() >= request.maglim)
+            return false;
+        offset  = sbl->nextRecordOffset();
+        pending = sbl->pendingRecordCount();
+    }
+
+    if (pending == 0)
+        return false;
+
+    // Take the page faults here, without holding the lock the paint path needs
+    reader->prefetchMapped(offset, quint64(pending) * reader->guessRecordSize());
+
+    QMutexLocker locker(&factory->mutex());
+    int nStars = sbl->getStarCount();
+    if (!sbl->fillToMag(request.maglim) && request.maglim <= request.component->faintMagnitude() * (1 - 1.5 / 16))
+        qCWarning(KSTARS) << "SBL::fillToMag(" << request.maglim << ") failed for trixel" << request.trixel;
+
+    return sbl->getStarCount() != nStars;
+}
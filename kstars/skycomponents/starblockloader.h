@@ -0,0 +1,106 @@
+/***************************************************************************
+                  starblockloader.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "typedef.h"
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+class DeepStarComponent;
+
+/**
+ * @class StarBlockLoader
+ *
+ * Fills the StarBlockLists of dynamically loaded star catalogs on a background thread.
+ *
+ * DeepStarComponent::draw() only draws the stars that are already in memory, and hands the
+ * trixels of the current view (and of the view predicted from the slew direction) that still
+ * lack stars to this loader. The loader first faults in the relevant part of the memory-mapped
+ * catalog without holding any lock, then fills the StarBlockList under the StarBlockFactory
+ * mutex, so that the paint path never waits on the disk. Once the queue drains, blocksLoaded()
+ * is emitted so that the sky map can be repainted with the new stars.
+ *
+ * @short Background loader for StarBlocks of deep star catalogs
+ */
+class StarBlockLoader : public QThread
+{
+    Q_OBJECT
+
+  public:
+    static StarBlockLoader *Instance();
+
+    /** @short The instance if it was created and not released yet, nullptr otherwise. Never starts the thread. */
+    static StarBlockLoader *existingInstance() { return pInstance; }
+
+    /** @short Stop the loader thread and delete the instance, if any */
+    static void Release();
+
+    ~StarBlockLoader() override;
+
+    /**
+     * @short  Queue trixels of a catalog for loading
+     *
+     * Any request still pending for this component is replaced, since it belongs to a view that is
+     * no longer current. Trixels are loaded in the order given, so the trixels of the current view
+     * should come first.
+     * @param  component  The catalog to load stars from
+     * @param  trixels    Trixels to fill
+     * @param  maglim     Magnitude to fill the trixels to
+     */
+    void request(DeepStarComponent *component, const QVector<Trixel> &trixels, float maglim);
+
+    /**
+     * @short  Drop all pending requests for the given component and wait for a running one to finish
+     * @note   Must be called before the component is destroyed
+     */
+    void cancel(DeepStarComponent *component);
+
+  signals:
+    /** @short Emitted from the loader thread when new stars became available */
+    void blocksLoaded();
+
+  protected:
+    void run() override;
+
+  private:
+    StarBlockLoader();
+
+    struct Request
+    {
+        DeepStarComponent *component;
+        Trixel trixel;
+        float maglim;
+    };
+
+    /**
+     * @short  Fill a single trixel
+     * @return true if any stars were added
+     */
+    bool load(const Request &request);
+
+    QMutex m_QueueMutex;
+    QWaitCondition m_QueueCondition;
+    QWaitCondition m_IdleCondition;
+    QList<Request> m_Queue;
+    DeepStarComponent *m_Current { nullptr };
+    bool m_Abort { false };
+
+    static StarBlockLoader *pInstance;
+};
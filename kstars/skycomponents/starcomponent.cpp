@@ -28,6 +28,7 @@
 #include "Options.h"
 #include "skylabeler.h"
 #include "skymap.h"
+#include "skymapprofiler.h"
 #include "skymesh.h"
 #ifndef KSTARS_LITE
 #include "skyqpainter.h"
@@ -314,35 +315,67 @@ void StarComponent::draw(SkyPainter *skyp)
 
     m_StarBlockFactory->drawID = m_skyMesh->drawID();
 
-    int nTrixels = 0;
+    // Dynamically loaded blocks are filled by the StarBlockLoader thread, which must not touch them while we draw
+    QMutexLocker cacheLocker(&m_StarBlockFactory->mutex());
 
+    // Queue the coordinate update of everything we are about to draw, named and unnamed stars alike
+    m_DrawLists.clear();
     while (region.hasNext())
     {
-        ++nTrixels;
-        Trixel currentRegion = region.next();
-        StarList *starList   = m_starIndex->at(currentRegion);
+        StarList *starList = m_starIndex->at(region.next());
+        m_UpdatePool.addList(starList, maglim);
+        m_DrawLists.append(starList);
+    }
+    SkyMapProfiler::count(SkyMapProfiler::TrixelsVisited, m_DrawLists.size());
+
+    QVector<DeepStarComponent *> preparedComponents;
+    for (auto &component : m_DeepStarComponents)
+    {
+        if (component->prepareDraw(m_UpdatePool))
+            preparedComponents.append(component);
+    }
+
+    {
+        SkyMapProfiler::Scope scope(SkyMapProfiler::Update, "Stars");
+        m_UpdatePool.run();
+    }
 
+#ifdef PROFILE_UPDATECOORDS
+    const StarUpdatePool::Statistics &stats = m_UpdatePool.statistics();
+    qDebug() << "Updated up to" << stats.stars << "stars in" << stats.jobs << "jobs," << stats.chunks << "chunks on"
+             << stats.threads << "threads in" << stats.elapsed << "us";
+#endif
+
+    for (StarList *starList : m_DrawLists)
+    {
+        // Stars are sorted by magnitude, project and draw those bright enough in one batch
+        m_DrawBatch.clear();
         for (auto &star : *starList)
         {
             if (!star)
                 continue;
 
-            float mag = star->mag();
-
             // break loop if maglim is reached
-            if (mag > maglim)
+            if (star->mag() > maglim)
                 break;
 
-            if (star->updateID != updateID)
-                star->JITupdate();
+            m_DrawBatch.append(star);
+        }
 
-            bool drawn = skyp->drawPointSource(star, mag, star->spchar());
+        m_DrawBatchDrawn.resize(m_DrawBatch.size());
+        const int drawnCount = skyp->drawPointSources(m_DrawBatch.constData(), m_DrawBatch.size(), m_DrawBatchDrawn.data());
+        SkyMapProfiler::count(SkyMapProfiler::StarsDrawn, drawnCount);
+        if (drawnCount == 0 || m_hideLabels)
+            continue;
 
-            //FIXME_SKYPAINTER: find a better way to do this.
-            if (drawn && !(m_hideLabels || mag > labelMagLim))
-                addLabel(proj->toScreen(star), star);
+        //FIXME_SKYPAINTER: find a better way to do this.
+        for (int i = 0; i < m_DrawBatch.size() && m_DrawBatch[i]->mag() <= labelMagLim; i++)
+        {
+            if (m_DrawBatchDrawn[i])
+                addLabel(proj->toScreen(m_DrawBatch[i]), m_DrawBatch[i]);
         }
     }
+    skyp->flushPointSources();
 
     // Draw focusStar if not null
     if (focusStar)
@@ -354,9 +387,9 @@ void StarComponent::draw(SkyPainter *skyp)
     }
 
     // Now draw each of our DeepStarComponents
-    for (auto &component : m_DeepStarComponents)
+    for (auto &component : preparedComponents)
     {
-        component->draw(skyp);
+        component->drawPrepared(skyp);
     }
 #else
     Q_UNUSED(skyp)
@@ -643,14 +676,18 @@ StarObject *StarComponent::findByHDIndex(int HDnum)
         ret = fread(&offset, 4, 1, hdidxFile);
         if (offset <= 0)
             return nullptr;
-        dataFile = m_DeepStarComponents.at(1)->getStarReader()->getFileHandle();
-        //KDE_fseek( dataFile, offset, SEEK_SET );
-        QT_FSEEK(dataFile, offset, SEEK_SET);
+        BinFileHelper *starReader = m_DeepStarComponents.at(1)->getStarReader();
+        if (!starReader->readMappedRecord(offset, &stardata))
         {
+            // The file handle is shared with the StarBlockLoader thread
+            QMutexLocker locker(&m_StarBlockFactory->mutex());
+            dataFile = starReader->getFileHandle();
+            //KDE_fseek( dataFile, offset, SEEK_SET );
+            QT_FSEEK(dataFile, offset, SEEK_SET);
             int rc = fread(&stardata, sizeof(StarData), 1, dataFile);
             Q_UNUSED(rc)
         }
-        if (m_DeepStarComponents.at(1)->getStarReader()->getByteSwap())
+        if (starReader->getByteSwap())
         {
             byteSwap(&stardata);
         }
@@ -21,6 +21,7 @@
 #include "listcomponent.h"
 #include "skylabel.h"
 #include "stardata.h"
+#include "starupdatepool.h"
 #include "skyobjects/starobject.h"
 
 #include <memory>
@@ -194,6 +195,14 @@ class StarComponent : public ListComponent
     QHash<int, StarObject *> m_HDHash;
     QVector<DeepStarComponent *> m_DeepStarComponents;
 
+    /// Coordinate update of all stars drawn in a frame
+    StarUpdatePool m_UpdatePool;
+    /// Named star lists of the trixels drawn in the current frame
+    QVector<StarList *> m_DrawLists;
+    /// Stars of the list being drawn, kept to reuse the allocation
+    QVector<StarObject *> m_DrawBatch;
+    QVector<bool> m_DrawBatchDrawn;
+
     /**
      * @struct starName
      * @brief Structure that holds star name information, to be read as-is from the
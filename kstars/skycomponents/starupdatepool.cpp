@@ -0,0 +1,143 @@
+/***************************************************************************
+                 starupdatepool.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "starupdatepool.h"
+
+#include "kstarsdata.h"
+#include "starblock.h"
+#include "skyobjects/starobject.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+// Below this many stars per chunk, the cost of claiming a chunk is no longer negligible
+#define MIN_CHUNK_STARS 256
+// Number of chunks per thread we aim for, so that threads finishing early have something to pick up
+#define CHUNKS_PER_THREAD 8
+
+void StarUpdatePool::clear()
+{
+    m_Jobs.clear();
+    m_ChunkStart.clear();
+    m_StarCount = 0;
+}
+
+void StarUpdatePool::addBlock(const std::shared_ptr<StarBlock> &block, float maglim)
+{
+    if (!block || block->getStarCount() == 0)
+        return;
+
+    m_Jobs.append({ block, nullptr, maglim });
+    m_StarCount += block->getStarCount();
+}
+
+void StarUpdatePool::addList(const StarList *list, float maglim)
+{
+    if (!list || list->isEmpty())
+        return;
+
+    m_Jobs.append({ std::shared_ptr<StarBlock>(), list, maglim });
+    m_StarCount += list->size();
+}
+
+void StarUpdatePool::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const int maxThreads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    const qint64 chunkStars = qMax<qint64>(MIN_CHUNK_STARS, m_StarCount / (maxThreads * CHUNKS_PER_THREAD));
+
+    // Cut the jobs into chunks of about chunkStars stars each
+    m_ChunkStart.clear();
+    qint64 stars = chunkStars;
+    for (int i = 0; i < m_Jobs.size(); ++i)
+    {
+        if (stars >= chunkStars)
+        {
+            m_ChunkStart.append(i);
+            stars = 0;
+        }
+        stars += m_Jobs[i].block ? m_Jobs[i].block->getStarCount() : m_Jobs[i].list->size();
+    }
+    const int chunks = m_ChunkStart.size();
+    m_ChunkStart.append(m_Jobs.size());
+
+    QAtomicInt nextChunk(0);
+    auto worker = [this, &nextChunk, chunks]()
+    {
+        int chunk;
+        while ((chunk = nextChunk.fetchAndAddRelaxed(1)) < chunks)
+            processChunk(chunk);
+    };
+
+    // The calling thread works too. Helpers that did not get to start before the work ran out are
+    // stolen back and run (as no-ops) by waitForFinished().
+    const int helpers = qMin(maxThreads, chunks) - 1;
+    QVector<QFuture<void>> futures;
+    for (int i = 0; i < helpers; ++i)
+        futures.append(QtConcurrent::run(worker));
+    worker();
+    for (auto &future : futures)
+        future.waitForFinished();
+
+    m_Statistics.jobs    = m_Jobs.size();
+    m_Statistics.chunks  = chunks;
+    m_Statistics.threads = helpers + 1;
+    m_Statistics.stars   = m_StarCount;
+    m_Statistics.elapsed = timer.nsecsElapsed() / 1000;
+
+    clear();
+}
+
+void StarUpdatePool::processChunk(int chunk)
+{
+    static KStarsData *data = KStarsData::Instance();
+    const UpdateID updateID = data->updateID();
+
+    for (int i = m_ChunkStart[chunk]; i < m_ChunkStart[chunk + 1]; ++i)
+    {
+        const Job &job = m_Jobs[i];
+
+        if (job.block)
+        {
+#ifdef KSTARS_LITE
+            for (StarBlock::StarBlockEntry &entry : job.block->contents())
+            {
+                if (entry.star.updateID != updateID)
+                    entry.star.JITupdate();
+                if (entry.star.mag() > job.maglim)
+                    break;
+            }
+#else
+            job.block->JITupdate(job.maglim);
+#endif
+            continue;
+        }
+
+        for (StarObject *star : *job.list)
+        {
+            if (!star)
+                continue;
+            if (star->mag() > job.maglim)
+                break;
+            if (star->updateID != updateID)
+                star->JITupdate();
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+                  starupdatepool.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include "typedef.h"
+
+#include <QVector>
+
+#include <memory>
+
+class StarBlock;
+
+/**
+ * @class StarUpdatePool
+ *
+ * Collects all the stars that are about to be drawn in a frame, from the StarBlocks of the
+ * DeepStarComponents and from the named star index of the StarComponent, and brings their
+ * coordinates up to date in a single parallel pass.
+ *
+ * The collected jobs are grouped into chunks of roughly equal star count. The calling thread and
+ * up to one task per thread of the global QThreadPool then repeatedly claim the next unprocessed
+ * chunk, so that fast threads pick up the work of slow ones. This replaces one
+ * QtConcurrent::blockingMap() dispatch and join per trixel by one per frame.
+ *
+ * @short Frame-level parallel coordinate update of stars
+ */
+class StarUpdatePool
+{
+  public:
+    /** @short Counters describing the last call to run() */
+    struct Statistics
+    {
+        /// Number of StarBlocks and star lists updated
+        int jobs { 0 };
+        /// Number of chunks the jobs were split into
+        int chunks { 0 };
+        /// Number of threads that took part, including the calling one
+        int threads { 0 };
+        /// Upper bound of the number of stars updated
+        qint64 stars { 0 };
+        /// Wall time spent in run(), in microseconds
+        qint64 elapsed { 0 };
+    };
+
+    /** @short Drop all queued jobs, keeping the allocated memory for the next frame */
+    void clear();
+
+    /**
+     * @short Queue a StarBlock for update
+     * @param block The block to update
+     * @param maglim Stars are updated up to and including the first one fainter than this magnitude
+     */
+    void addBlock(const std::shared_ptr<StarBlock> &block, float maglim);
+
+    /**
+     * @short Queue a list of stars sorted by magnitude for update
+     * @param list The list to update
+     * @param maglim Stars fainter than this magnitude are not updated
+     */
+    void addList(const StarList *list, float maglim);
+
+    /**
+     * @short Update all queued stars, and clear the queue
+     * @note Blocks until all stars are updated. The StarBlockFactory mutex must be held if any
+     * dynamically loaded block was queued.
+     */
+    void run();
+
+    /** @return the counters of the last call to run() */
+    inline const Statistics &statistics() const { return m_Statistics; }
+
+  private:
+    struct Job
+    {
+        std::shared_ptr<StarBlock> block;
+        const StarList *list;
+        float maglim;
+    };
+
+    /** @short Update the jobs of the given chunk */
+    void processChunk(int chunk);
+
+    QVector<Job> m_Jobs;
+    /// Index of the first job of each chunk, followed by the number of jobs
+    QVector<int> m_ChunkStart;
+    qint64 m_StarCount { 0 };
+    Statistics m_Statistics;
+};
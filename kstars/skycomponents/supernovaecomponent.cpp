@@ -45,12 +45,16 @@ void SupernovaeComponent::update(KSNumbers *num)
         return;
 
     KStarsData *data = KStarsData::Instance();
+
+    QVector<SkyPoint *> points;
+    points.reserve(m_ObjectList.size());
     for (auto so : m_ObjectList)
     {
         if (num)
             so->updateCoords(num);
-        so->EquatorialToHorizontal(data->lst(), data->geo()->lat());
+        points.append(so);
     }
+    SkyPoint::EquatorialToHorizontal(points.constData(), points.size(), data->lst(), data->geo()->lat());
 }
 
 bool SupernovaeComponent::selected()
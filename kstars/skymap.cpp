@@ -44,6 +44,7 @@
 #include "dialogs/detaildialog.h"
 #include "printing/printingwizard.h"
 #include "skycomponents/flagcomponent.h"
+#include "skycomponents/starblockloader.h"
 #include "skyobjects/deepskyobject.h"
 #include "skyobjects/ksplanetbase.h"
 #include "tools/flagmanager.h"
@@ -194,6 +195,11 @@ SkyMap::SkyMap()
     connect(&m_HoverTimer, SIGNAL(timeout()), this, SLOT(slotTransientLabel()));
     connect(this, SIGNAL(destinationChanged()), this, SLOT(slewFocus()));
     connect(KStarsData::Instance(), SIGNAL(skyUpdate(bool)), this, SLOT(slotUpdateSky(bool)));
+    // Repaint once the background loader has brought in the deep stars of the current view
+    connect(StarBlockLoader::Instance(), &StarBlockLoader::blocksLoaded, this, [this]()
+    {
+        forceUpdate();
+    }, Qt::QueuedConnection);
 
     // Time infobox
     m_timeBox = new InfoBoxWidget(Options::shadeTimeBox(), Options::positionTimeBox(), Options::stickyTimeBox(),
@@ -20,7 +20,9 @@
 #include "skymap.h"
 #include "projections/projector.h"
 #include "printing/legend.h"
+#include "skycomponents/skymapprofiler.h"
 #include "kstars_debug.h"
+#include "Options.h"
 #include <QPainterPath>
 
 SkyMapQDraw::SkyMapQDraw(SkyMap *sm) : QWidget(sm), SkyMapDrawAbstract(sm)
@@ -66,12 +68,24 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
         return; // exit because the pixmap is repainted and that's all what we want
     }
 
+    SkyMapProfiler::Instance()->beginFrame();
+
     // FIXME: used to notify infobox about possible change of object coordinates
     // Not elegant at all. Should find better option
     m_SkyMap->showFocusCoords();
     m_SkyMap->setupProjector();
 
-    SkyQPainter psky(this, m_SkyPixmap);
+    // When tiled, the sky is rendered into an image, whose rows the painter hands out to worker threads.
+    // Labels and other overlays are still placed by the components in a single pass.
+    QImage skyImage;
+    QPaintDevice *skyDevice = m_SkyPixmap;
+    if (Options::tiledSkyMap())
+    {
+        skyImage  = QImage(m_SkyPixmap->size(), QImage::Format_ARGB32_Premultiplied);
+        skyDevice = &skyImage;
+    }
+
+    SkyQPainter psky(this, skyDevice);
     //FIXME: we may want to move this into the components.
     psky.begin();
 
@@ -88,6 +102,11 @@ void SkyMapQDraw::paintEvent(QPaintEvent *event)
     //Finish up
     psky.end();
 
+    if (!skyImage.isNull())
+        *m_SkyPixmap = QPixmap::fromImage(std::move(skyImage));
+
+    SkyMapProfiler::Instance()->endFrame();
+
     QPainter psky2;
     psky2.begin(this);
     psky2.drawLine(0, 0, 1, 1); // Dummy op.
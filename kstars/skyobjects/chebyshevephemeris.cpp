@@ -0,0 +1,128 @@
+/***************************************************************************
+                chebyshevephemeris.cpp  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "chebyshevephemeris.h"
+
+#include "dms.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+
+#include <cmath>
+
+// Past this many segments per body, the cache is emptied before fitting a new one, which keeps
+// the memory bounded when scanning centuries with a short span
+#define MAX_SEGMENTS 4096
+
+ChebyshevEphemeris::ChebyshevEphemeris(double span, int degree) : m_Span(span), m_Degree(degree)
+{
+}
+
+QVector<double> ChebyshevEphemeris::fit(qint64 index, const Series &series) const
+{
+    const int n        = m_Degree + 1;
+    const double start = index * m_Span;
+
+    // Series at the n Chebyshev nodes of the segment
+    QVector<double> values(3 * n);
+    for (int k = 0; k < n; ++k)
+    {
+        const double x = cos(dms::PI * (k + 0.5) / n);
+        double xyz[3];
+        series(start + 0.5 * (x + 1.0) * m_Span, xyz);
+        for (int c = 0; c < 3; ++c)
+            values[c * n + k] = xyz[c];
+    }
+
+    // Discrete Chebyshev transform, exact at the nodes
+    QVector<double> coefficients(3 * n);
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < n; ++k)
+                sum += values[c * n + k] * cos(dms::PI * j * (k + 0.5) / n);
+            coefficients[c * n + j] = (j == 0 ? 1.0 : 2.0) * sum / n;
+        }
+    }
+
+    return coefficients;
+}
+
+void ChebyshevEphemeris::evaluate(double t, double xyz[3], const Series &series)
+{
+    const qint64 index = qint64(std::floor(t / m_Span));
+
+    QVector<double> coefficients;
+    {
+        QReadLocker locker(&m_Lock);
+        coefficients = m_Segments.value(index);
+    }
+
+    if (coefficients.isEmpty())
+    {
+        // Fit outside of the lock, so that other segments can still be read. Two threads may
+        // occasionally fit the same segment, with the same result.
+        coefficients = fit(index, series);
+
+        QWriteLocker locker(&m_Lock);
+        if (m_Segments.size() >= MAX_SEGMENTS)
+            m_Segments.clear();
+        m_Segments.insert(index, coefficients);
+    }
+
+    // Clenshaw's recurrence, for x in [-1, 1] over the segment
+    const int n    = m_Degree + 1;
+    const double x = 2.0 * (t - index * m_Span) / m_Span - 1.0;
+    for (int c = 0; c < 3; ++c)
+    {
+        const double *a = coefficients.constData() + c * n;
+        double b1 = 0.0, b2 = 0.0;
+        for (int j = n - 1; j >= 1; --j)
+        {
+            const double b = 2.0 * x * b1 - b2 + a[j];
+            b2             = b1;
+            b1             = b;
+        }
+        xyz[c] = x * b1 - b2 + a[0];
+    }
+}
+
+void ChebyshevEphemeris::clear()
+{
+    QWriteLocker locker(&m_Lock);
+    m_Segments.clear();
+}
+
+int ChebyshevEphemeris::segmentCount() const
+{
+    QReadLocker locker(&m_Lock);
+    return m_Segments.size();
+}
+
+ChebyshevEphemeris *ChebyshevEphemeris::instance(const QString &name, double span, int degree)
+{
+    static QMutex mutex;
+    static QHash<QString, QSharedPointer<ChebyshevEphemeris>> caches;
+
+    QMutexLocker locker(&mutex);
+    QSharedPointer<ChebyshevEphemeris> &cache = caches[name];
+    if (cache.isNull())
+        cache.reset(new ChebyshevEphemeris(span, degree));
+    return cache.data();
+}
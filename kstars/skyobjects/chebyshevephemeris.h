@@ -0,0 +1,86 @@
+/***************************************************************************
+                 chebyshevephemeris.h  -  K Desktop Planetarium
+                             -------------------
+    begin                : 2020
+    copyright            : (C) 2020 by KStars developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @class ChebyshevEphemeris
+ *
+ * Caches a position given by a slowly converging series, such as VSOP87 for the planets or
+ * the lunar theory of Meeus for the Moon, as Chebyshev polynomials over segments of time.
+ *
+ * Time is cut into consecutive segments of a fixed span. The first time a position is asked
+ * for in a segment, the series is evaluated at the Chebyshev nodes of the segment, and the three
+ * coordinates are fitted by polynomials of the given degree. Positions in that segment are then
+ * found by evaluating the polynomials, which is much cheaper than the series when many epochs are
+ * asked for, as in the conjunction tool or the altitude vs. time tool.
+ *
+ * The span and degree are chosen per body so that the fit is well below the accuracy of the
+ * series itself. Cartesian coordinates should be fitted rather than angles, which wrap around.
+ *
+ * Evaluation is thread-safe.
+ *
+ * @short Chebyshev interpolation of a series ephemeris
+ */
+class ChebyshevEphemeris
+{
+  public:
+    /** Evaluates the series at time t, and returns its three coordinates through xyz */
+    typedef std::function<void(double t, double xyz[3])> Series;
+
+    /**
+     * @param span length of the segments, in the unit of time of the series
+     * @param degree degree of the fitted polynomials
+     */
+    ChebyshevEphemeris(double span, int degree);
+
+    /**
+     * @short Find the coordinates at time t, fitting the segment with the series if needed
+     * @param t the time, in the unit of time of the series
+     * @param xyz the three coordinates are returned through this argument
+     * @param series the series this cache interpolates
+     */
+    void evaluate(double t, double xyz[3], const Series &series);
+
+    /** @short Forget all the fitted segments */
+    void clear();
+
+    /** @return the number of fitted segments */
+    int segmentCount() const;
+
+    /**
+     * @short The cache shared by all the objects of the given name
+     * The cache is created with the given span and degree the first time it is asked for.
+     */
+    static ChebyshevEphemeris *instance(const QString &name, double span, int degree);
+
+  private:
+    /** @return the coefficients of the three coordinates for segment index, one after the other */
+    QVector<double> fit(qint64 index, const Series &series) const;
+
+    double m_Span { 0 };
+    int m_Degree { 0 };
+
+    QHash<qint64, QVector<double>> m_Segments;
+    mutable QReadWriteLock m_Lock;
+};
@@ -103,57 +103,22 @@ bool KSAsteroid::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase
     vw.SinCos(sinvw, cosvw);
     i.SinCos(sini, cosi);
 
-    //xh, yh, zh are the heliocentric cartesian coords with the ecliptic plane congruent with zh=0.
-    double xh = r * (cosN * cosvw - sinN * sinvw * cosi);
-    double yh = r * (sinN * cosvw + cosN * sinvw * cosi);
-    double zh = r * (sinvw * sini);
-
-    //the spherical ecliptic coordinates:
-    double ELongRad = atan2(yh, xh);
-    double ELatRad  = atan2(zh, r);
-
-    helEcPos.longitude.setRadians(ELongRad);
-    helEcPos.longitude.reduceToRange(dms::ZERO_TO_2PI);
-    helEcPos.latitude.setRadians(ELatRad);
-    setRsun(r);
+    //the heliocentric cartesian coords with the ecliptic plane congruent with zh=0.
+    const double helio[3] = { r * (cosN * cosvw - sinN * sinvw * cosi), r * (sinN * cosvw + cosN * sinvw * cosi),
+                              r * (sinvw * sini) };
 
     if (Earth)
     {
-        //xe, ye, ze are the Earth's heliocentric cartesian coords
+        //the Earth's heliocentric cartesian coords
         double cosBe, sinBe, cosLe, sinLe;
         Earth->ecLong().SinCos(sinLe, cosLe);
         Earth->ecLat().SinCos(sinBe, cosBe);
 
-        double xe = Earth->rsun() * cosBe * cosLe;
-        double ye = Earth->rsun() * cosBe * sinLe;
-        double ze = Earth->rsun() * sinBe;
-
-        //convert to geocentric ecliptic coordinates by subtracting Earth's coords:
-        xh -= xe;
-        yh -= ye;
-        zh -= ze;
+        const double earth[3] = { Earth->rsun() * cosBe * cosLe, Earth->rsun() * cosBe * sinLe, Earth->rsun() * sinBe };
+        setEclipticPosition(num, helio, earth);
     }
-
-    //the spherical geocentricecliptic coordinates:
-    ELongRad  = atan2(yh, xh);
-    double rr = sqrt(xh * xh + yh * yh);
-    ELatRad   = atan2(zh, rr);
-
-    ep.longitude.setRadians(ELongRad);
-    ep.longitude.reduceToRange(dms::ZERO_TO_2PI);
-    ep.latitude.setRadians(ELatRad);
-    if (Earth)
-        setRearth(Earth);
-
-    EclipticToEquatorial(num->obliquity());
-
-    // JM 2017-09-10: The calculations above produce J2000 RESULTS
-    // So we have to precess as well
-    setRA0(ra());
-    setDec0(dec());
-    apparentCoord(J2000, lastPrecessJD);
-    //nutate(num);
-    //aberrate(num);
+    else
+        setEclipticPosition(num, helio, nullptr);
 
     return true;
 }
@@ -231,6 +231,8 @@ class KSAsteroid : public KSPlanetBase
     friend QDataStream &operator<<(QDataStream &out, const KSAsteroid &asteroid);
     friend QDataStream &operator>>(QDataStream &in, KSAsteroid *&asteroid);
 
+    friend class OrbitPropagator;
+
     void findMagnitude(const KSNumbers *) override;
 
     int catN { 0 };
@@ -48,16 +48,11 @@ int letterDesigToN(QString s)
 }
 
 QMap<QChar, qint64> cometType;
-}
 
-KSComet::KSComet(const QString &_s, const QString &imfile, double _q, double _e, dms _i, dms _w,
-                 dms _Node, double Tp, float _M1, float _M2, float _K1, float _K2)
-    : KSPlanetBase(_s, imfile), q(_q), e(_e), M1(_M1), M2(_M2), K1(_K1), K2(_K2), i(_i), w(_w), N(_Node)
+// Find the Julian Day of Perihelion from Tp
+// Tp is a double which encodes a date like: YYYYMMDD.DDDDD (e.g., 19730521.33333
+long double perihelionJD(double Tp)
 {
-    setType(SkyObject::COMET);
-
-    //Find the Julian Day of Perihelion from Tp
-    //Tp is a double which encodes a date like: YYYYMMDD.DDDDD (e.g., 19730521.33333
     int year    = int(Tp / 10000.0);
     int month   = int((int(Tp) % 10000) / 100.0);
     int day     = int(int(Tp) % 100);
@@ -66,7 +61,21 @@ KSComet::KSComet(const QString &_s, const QString &imfile, double _q, double _e,
     int m       = int(60.0 * (Hour - h));
     int s       = int(60.0 * (60.0 * (Hour - h) - m));
 
-    JDp   = KStarsDateTime(QDate(year, month, day), QTime(h, m, s)).djd();
+    return KStarsDateTime(QDate(year, month, day), QTime(h, m, s)).djd();
+}
+}
+
+KSComet::KSComet(const QString &_s, const QString &imfile, double _q, double _e, dms _i, dms _w,
+                 dms _Node, double Tp, float _M1, float _M2, float _K1, float _K2)
+    : KSComet(_s, imfile, perihelionJD(Tp), _q, _e, _i, _w, _Node, _M1, _M2, _K1, _K2)
+{
+}
+
+KSComet::KSComet(const QString &_s, const QString &imfile, long double _JDp, double _q, double _e, dms _i, dms _w,
+                 dms _Node, float _M1, float _M2, float _K1, float _K2)
+    : KSPlanetBase(_s, imfile), JDp(_JDp), q(_q), e(_e), M1(_M1), M2(_M2), K1(_K1), K2(_K2), i(_i), w(_w), N(_Node)
+{
+    setType(SkyObject::COMET);
 
     //compute the semi-major axis, a:
     if (e == 1)
@@ -250,59 +259,25 @@ bool KSComet::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *E
     // Inclination
     i.SinCos(sini, cosi);
 
-    //xh, yh, zh are the heliocentric cartesian coords with the ecliptic plane congruent with zh=0.
-    double xh = r * (cosN * cosvw - sinN * sinvw * cosi);
-    double yh = r * (sinN * cosvw + cosN * sinvw * cosi);
-    double zh = r * (sinvw * sini);
-
-    //the spherical ecliptic coordinates:
-    double ELongRad = atan2(yh, xh);
-    double ELatRad  = atan2(zh, r);
-
-    helEcPos.longitude.setRadians(ELongRad);
-    helEcPos.longitude.reduceToRange(dms::ZERO_TO_2PI);
-    helEcPos.latitude.setRadians(ELatRad);
-    setRsun(r);
+    //the heliocentric cartesian coords with the ecliptic plane congruent with zh=0.
+    const double helio[3] = { r * (cosN * cosvw - sinN * sinvw * cosi), r * (sinN * cosvw + cosN * sinvw * cosi),
+                              r * (sinvw * sini) };
 
-    //xe, ye, ze are the Earth's heliocentric cartesian coords
+    //the Earth's heliocentric cartesian coords
     double cosBe, sinBe, cosLe, sinLe;
     Earth->ecLong().SinCos(sinLe, cosLe);
     Earth->ecLat().SinCos(sinBe, cosBe);
 
-    double xe = Earth->rsun() * cosBe * cosLe;
-    double ye = Earth->rsun() * cosBe * sinLe;
-    double ze = Earth->rsun() * sinBe;
+    const double earth[3] = { Earth->rsun() * cosBe * cosLe, Earth->rsun() * cosBe * sinLe, Earth->rsun() * sinBe };
+    setEclipticPosition(num, helio, earth);
 
-    //convert to geocentric ecliptic coordinates by subtracting Earth's coords:
-    xh -= xe;
-    yh -= ye;
-    zh -= ze;
-
-    //Finally, the spherical ecliptic coordinates:
-    ELongRad  = atan2(yh, xh);
-    double rr = sqrt(xh * xh + yh * yh);
-    ELatRad   = atan2(zh, rr);
-
-    ep.longitude.setRadians(ELongRad);
-    ep.longitude.reduceToRange(dms::ZERO_TO_2PI);
-    ep.latitude.setRadians(ELatRad);
-    setRearth(Earth);
-
-    // Now convert to geocentric equatorial coords
-    EclipticToEquatorial(num->obliquity());
-
-    // JM 2017-09-10: The calculations above produce J2000 RESULTS
-    // So we have to precess as well
-    setRA0(ra());
-    setDec0(dec());
-    apparentCoord(J2000, lastPrecessJD);
-
-    //nutate(num);
-    //aberrate(num);
+    return true;
+}
 
+void KSComet::setEclipticPosition(const KSNumbers *num, const double helio[3], const double *earth)
+{
+    KSPlanetBase::setEclipticPosition(num, helio, earth);
     findPhysicalParameters();
-
-    return true;
 }
 
 //T-mag =  M1 + 5*log10(delta) + k1*log10(r)
@@ -356,6 +331,48 @@ void KSComet::setRotationPeriod(float rot_per)
     RotationPeriod = rot_per;
 }
 
+QDataStream &operator<<(QDataStream &out, const KSComet &comet)
+{
+    out << comet.Name << comet.OrbitClass << comet.Dimensions << comet.OrbitID
+        << comet.q << comet.e << comet.i << comet.w << comet.N << static_cast<double>(comet.JDp)
+        << comet.M1 << comet.M2 << comet.K1 << comet.K2
+        << comet.NEO << comet.Diameter << comet.Albedo << comet.RotationPeriod
+        << comet.Period << comet.EarthMOID;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, KSComet *&comet)
+{
+    QString name, orbit_id, orbit_class, dimensions;
+    double q, e, JDp, earth_moid;
+    dms i, w, N;
+    float M1, M2, K1, K2, diameter, albedo, rot_period, period;
+    bool neo;
+
+    in >> name;
+    in >> orbit_class;
+    in >> dimensions;
+    in >> orbit_id;
+
+    in >> q >> e >> i >> w >> N >> JDp >> M1 >> M2 >> K1 >> K2 >> neo >> diameter >> albedo >> rot_period
+       >> period >> earth_moid;
+
+    // The time of perihelion was stored as a Julian Day already
+    comet = new KSComet(name, QString(), JDp, q, e, i, w, N, M1, M2, K1, K2);
+    comet->setOrbitID(orbit_id);
+    comet->setNEO(neo);
+    comet->setDiameter(diameter);
+    comet->setDimensions(dimensions);
+    comet->setAlbedo(albedo);
+    comet->setRotationPeriod(rot_period);
+    comet->setPeriod(period);
+    comet->setEarthMOID(earth_moid);
+    comet->setOrbitClass(orbit_class);
+    comet->setAngularSize(0.005);
+
+    return in;
+}
+
 //Unused virtual function from KSPlanetBase
 bool KSComet::loadData()
 {
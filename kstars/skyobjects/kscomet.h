@@ -19,6 +19,8 @@
 
 #include "ksplanetbase.h"
 
+#include <QDataStream>
+
 /**
  * @class KSComet
  * @short A subclass of KSPlanetBase that implements comets.
@@ -72,9 +74,29 @@ class KSComet : public KSPlanetBase
     KSComet(const QString &s, const QString &image_file, double q, double e, dms i, dms w, dms N,
             double Tp, float M1, float M2, float K1, float K2);
 
+    /**
+     * Constructor from the Julian Day of perihelion, e.g. as stored in the binary cache.
+     * @param s the name of the comet
+     * @param image_file the filename for an image of the comet
+     * @param JDp the Julian Day of the most proximate perihelion passage
+     * @param q the perihelion distance of the comet's orbit (AU)
+     * @param e the eccentricity of the comet's orbit
+     * @param i the inclination angle of the comet's orbit
+     * @param w the argument of the orbit's perihelion
+     * @param N the longitude of the orbit's ascending node
+     * @param M1 the comet total magnitude parameter
+     * @param M2 the comet nuclear magnitude parameter
+     * @param K1 the comet total magnitude slope parameter
+     * @param K2 the comet nuclear magnitude slope parameter
+     */
+    KSComet(const QString &s, const QString &image_file, long double JDp, double q, double e, dms i, dms w, dms N,
+            float M1, float M2, float K1, float K2);
+
     KSComet *clone() const override;
     SkyObject::UID getUID() const override;
 
+    static const SkyObject::TYPE TYPE = SkyObject::COMET;
+
     /** Destructor (empty)*/
     ~KSComet() override = default;
 
@@ -186,6 +208,9 @@ class KSComet : public KSPlanetBase
      */
     bool findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *Earth = nullptr) override;
 
+    /** @note reimplemented from KSPlanetBase, to also estimate the physical parameters */
+    void setEclipticPosition(const KSNumbers *num, const double helio[3], const double *earth) override;
+
     /**
      * @short Estimate physical parameters of the comet such as coma size, tail length and size of the nucleus
      * @note invoked from findGeocentricPosition in order
@@ -193,6 +218,14 @@ class KSComet : public KSPlanetBase
     void findPhysicalParameters();
 
   private:
+    /**
+     * Serializers
+     */
+    friend QDataStream &operator<<(QDataStream &out, const KSComet &comet);
+    friend QDataStream &operator>>(QDataStream &in, KSComet *&comet);
+
+    friend class OrbitPropagator;
+
     void findMagnitude(const KSNumbers *) override;
 
     long double JDp { 0 };
@@ -17,10 +17,12 @@
 
 #include "ksmoon.h"
 
+#include "chebyshevephemeris.h"
 #include "ksnumbers.h"
 #include "ksutils.h"
 #include "kssun.h"
 #include "kstarsdata.h"
+#include "Options.h"
 #ifndef KSTARS_LITE
 #include "kspopupmenu.h"
 #endif
@@ -41,6 +43,11 @@
 
 using namespace std;
 
+// Span in days and degree of the Chebyshev segments fitted to the lunar series, which keep the
+// interpolation error below 0.01 arcsecond, as checked by TestChebyshevEphemeris
+#define MOON_SEGMENT_SPAN   8.0
+#define MOON_SEGMENT_DEGREE 14
+
 namespace
 {
 // Convert degrees to radians and put it into [0,2*pi] range
@@ -158,18 +165,15 @@ bool KSMoon::loadData()
     return true;
 }
 
-bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
+void KSMoon::calcEcliptic(double T, double &longitude, double &latitude, double &distance)
 {
     //Algorithms in this subroutine are taken from Chapter 45 of "Astronomical Algorithms"
     //by Jean Meeus (1991, Willmann-Bell, Inc. ISBN 0-943396-35-2.  https://www.willbell.com/math/mc1.htm)
     //updated to Jean Messus (1998, Willmann-Bell, http://www.naughter.com/aa.html )
 
-    double T, L, D, M, M1, F, A1, A2, A3;
+    double L, D, M, M1, F, A1, A2, A3;
     double sumL, sumR, sumB;
 
-    //Julian centuries since J2000
-    T = num->julianCenturies();
-
     double Et = 1.0 - 0.002516 * T - 0.0000074 * T * T;
 
     //Moon's mean longitude
@@ -196,9 +200,6 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
     sumL = 0.0;
     sumR = 0.0;
 
-    if (!loadData())
-        return false;
-
     for (const auto &mlrd : LRData)
     {
         double E = 1.0;
@@ -233,9 +234,48 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
              115.0 * sin(L + M1));
 
     //Geocentric coordinates
-    setEcLong(dms(sumL / 1000000.0 + L * 180.0 / dms::PI)); //convert radians to degrees
-    setEcLat(dms(sumB / 1000000.0));
-    Rearth = (385000.56 + sumR / 1000.0) / AU_KM; //distance from Earth, in AU
+    longitude = sumL / 1000000.0 * dms::DegToRad + L;
+    latitude  = sumB / 1000000.0 * dms::DegToRad;
+    distance  = 385000.56 + sumR / 1000.0; //distance from Earth, in km
+}
+
+bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
+{
+    double longitude, latitude, distance;
+
+    if (!loadData())
+        return false;
+
+    //Julian centuries since J2000
+    const double T = num->julianCenturies();
+
+    if (Options::ephemerisCache())
+    {
+        // The geocentric rectangular coordinates are interpolated, as the longitude wraps around
+        ChebyshevEphemeris *cache =
+            ChebyshevEphemeris::instance("Moon", MOON_SEGMENT_SPAN / 36525.0, MOON_SEGMENT_DEGREE);
+        double xyz[3];
+        cache->evaluate(T, xyz, [](double t, double position[3])
+        {
+            double l, b, r;
+            calcEcliptic(t, l, b, r);
+            position[0] = r * cos(b) * cos(l);
+            position[1] = r * cos(b) * sin(l);
+            position[2] = r * sin(b);
+        });
+
+        const double rho = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+        longitude        = atan2(xyz[1], xyz[0]);
+        latitude         = atan2(xyz[2], rho);
+        distance         = sqrt(rho * rho + xyz[2] * xyz[2]);
+    }
+    else
+        calcEcliptic(T, longitude, latitude, distance);
+
+    //Geocentric coordinates
+    setEcLong(dms(longitude * 180.0 / dms::PI)); //convert radians to degrees
+    setEcLat(dms(latitude * 180.0 / dms::PI));
+    Rearth = distance / AU_KM; //distance from Earth, in AU
 
     EclipticToEquatorial(num->obliquity());
 
@@ -245,6 +285,19 @@ bool KSMoon::findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *)
     return true;
 }
 
+void KSMoon::findLocalPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST)
+{
+    lastPrecessJD = num->julianDay();
+
+    findGeocentricPosition(num, nullptr);
+
+    // Same approximation as findPhase(), the Sun being at its true longitude
+    Phase = (ecLong() - num->sunTrueLongitude()).Degrees();
+
+    localizeCoords(num, lat, LST);
+    EquatorialToHorizontal(LST, lat);
+}
+
 void KSMoon::findMagnitude(const KSNumbers *)
 {
     // This block of code to compute Moon magnitude (and the
@@ -77,12 +77,28 @@ class KSMoon : public KSPlanetBase
      * interaction is complex and nonlinear.  As a result, the positions as
      * calculated by findPosition() are only accurate to about 10 arcseconds
      * (10 times less precise than the planets' positions!)
+     * If the EphemerisCache option is set, the position is interpolated from the series by
+     * a ChebyshevEphemeris.
      * @short moon-specific coordinate finder
      * @param num KSNumbers pointer for the target date/time
      * @note we don't use the Earth pointer here
      */
     bool findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *) override;
 
+    /**
+     * @short Find the topocentric position, horizontal coordinates and phase of the Moon.
+     *
+     * Unlike updateCoords(), this does not update the Earth of the sky composite, nor look
+     * the Sun up, nor load the image of the phase. Copies of the Moon may thus be updated
+     * concurrently, provided loadData() was called beforehand. The phase uses the true solar
+     * longitude from @p num instead of the position of the Sun, which is accurate enough
+     * for the illuminated fraction.
+     * @param num KSNumbers pointer for the target date/time
+     * @param lat pointer to the geographic latitude
+     * @param LST pointer to the local sidereal time
+     */
+    void findLocalPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST);
+
     /**
      * @brief updateMag calls findMagnitude() to calculate current magnitude of moon
      * according to current phase. This function is required to perform findMagnitude()
@@ -95,6 +111,15 @@ class KSMoon : public KSPlanetBase
   private:
     void findMagnitude(const KSNumbers *) override;
 
+    /**
+     * @short Evaluate the lunar series, loaded by loadData()
+     * @param T Julian centuries since J2000
+     * @param longitude geocentric ecliptic longitude of date, in radians
+     * @param latitude geocentric ecliptic latitude, in radians
+     * @param distance distance from the Earth, in km
+     */
+    static void calcEcliptic(double T, double &longitude, double &latitude, double &distance);
+
     static bool data_loaded;
     static int instance_count;
 
@@ -17,9 +17,11 @@
 
 #include "ksplanet.h"
 
+#include "chebyshevephemeris.h"
 #include "ksnumbers.h"
 #include "ksutils.h"
 #include "ksfilereader.h"
+#include "Options.h"
 
 #include <cmath>
 #include <typeinfo>
@@ -28,6 +30,23 @@
 
 KSPlanet::OrbitDataManager KSPlanet::odm;
 
+namespace
+{
+// Span in days and degree of the Chebyshev segments fitted to the series of each planet, which
+// keep the interpolation error below 0.01 arcsecond, far below the accuracy of VSOP87 itself
+struct EphemerisSegments
+{
+    const char *planet;
+    double span;
+    int degree;
+};
+
+const EphemerisSegments ephemerisSegments[] = {
+    { "Mercury", 16, 12 }, { "Venus", 32, 12 },  { "Earth", 16, 10 },   { "Mars", 64, 12 },
+    { "Jupiter", 256, 12 }, { "Saturn", 256, 10 }, { "Uranus", 512, 10 }, { "Neptune", 512, 10 }
+};
+}
+
 KSPlanet::OrbitDataManager::OrbitDataManager()
 {
     //EMPTY
@@ -199,25 +218,70 @@ bool KSPlanet::loadData()
 
 void KSPlanet::calcEcliptic(double Tau, EclipticPosition &epret) const
 {
-    double sum[6];
     OrbitDataColl odc;
-    double Tpow[6];
+    const QString planet = untranslatedName();
 
-    Tpow[0] = 1.0;
-    for (int i = 1; i < 6; ++i)
-    {
-        Tpow[i] = Tpow[i - 1] * Tau;
-    }
-
-    if (!odm.loadData(odc, untranslatedName()))
+    if (!odm.loadData(odc, planet))
     {
         epret.longitude = dms(0.0);
         epret.latitude  = dms(0.0);
         epret.radius    = 0.0;
-        qCWarning(KSTARS) << "Could not get data for name:" << name() << "(" << untranslatedName() << ")";
+        qCWarning(KSTARS) << "Could not get data for name:" << name() << "(" << planet << ")";
         return;
     }
 
+    ChebyshevEphemeris *cache = nullptr;
+    if (Options::ephemerisCache())
+    {
+        for (const EphemerisSegments &segments : ephemerisSegments)
+        {
+            if (planet == segments.planet)
+            {
+                cache = ChebyshevEphemeris::instance(planet, segments.span / 365250.0, segments.degree);
+                break;
+            }
+        }
+    }
+
+    if (cache == nullptr)
+    {
+        calcEclipticSeries(Tau, odc, epret);
+        return;
+    }
+
+    // The heliocentric rectangular coordinates are interpolated, as the longitude wraps around
+    double xyz[3];
+    cache->evaluate(Tau, xyz, [&odc](double jm, double position[3])
+    {
+        EclipticPosition series;
+        double sinL, cosL, sinB, cosB;
+
+        calcEclipticSeries(jm, odc, series);
+        series.longitude.SinCos(sinL, cosL);
+        series.latitude.SinCos(sinB, cosB);
+        position[0] = series.radius * cosB * cosL;
+        position[1] = series.radius * cosB * sinL;
+        position[2] = series.radius * sinB;
+    });
+
+    const double rho = sqrt(xyz[0] * xyz[0] + xyz[1] * xyz[1]);
+    epret.longitude.setRadians(atan2(xyz[1], xyz[0]));
+    epret.longitude.setD(epret.longitude.reduce().Degrees());
+    epret.latitude.setRadians(atan2(xyz[2], rho));
+    epret.radius = sqrt(rho * rho + xyz[2] * xyz[2]);
+}
+
+void KSPlanet::calcEclipticSeries(double Tau, const OrbitDataColl &odc, EclipticPosition &epret)
+{
+    double sum[6];
+    double Tpow[6];
+
+    Tpow[0] = 1.0;
+    for (int i = 1; i < 6; ++i)
+    {
+        Tpow[i] = Tpow[i - 1] * Tau;
+    }
+
     //Ecliptic Longitude
     for (int i = 0; i < 6; ++i)
     {
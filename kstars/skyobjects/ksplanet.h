@@ -81,6 +81,8 @@ class KSPlanet : public KSPlanetBase
      * to the ecliptic coordinates is returned as the second object.
      * @param jm Julian Millenia (=jd/1000)
      * @param ret The ecliptic coordinates are returned by reference through this argument.
+     * @note If the EphemerisCache option is set, the position is interpolated from the
+     * series by a ChebyshevEphemeris shared by all the copies of the planet.
      */
     virtual void calcEcliptic(double jm, EclipticPosition &ret) const;
 
@@ -180,6 +182,9 @@ class KSPlanet : public KSPlanetBase
   private:
     void findMagnitude(const KSNumbers *) override;
 
+    /** @short Evaluate the VSOP87 series of odc, see calcEcliptic() */
+    static void calcEclipticSeries(double jm, const OrbitDataColl &odc, EclipticPosition &ret);
+
   protected:
     bool data_loaded { false };
     static OrbitDataManager odm;
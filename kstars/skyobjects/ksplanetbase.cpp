@@ -124,6 +124,64 @@ void KSPlanetBase::findPosition(const KSNumbers *num, const CachingDms *lat, con
     lastPrecessJD = num->julianDay();
 
     findGeocentricPosition(num, Earth); //private function, reimplemented in each subclass
+    finishPosition(num, lat, LST);
+}
+
+void KSPlanetBase::setHeliocentricPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST,
+                                           const double helio[3], const double earth[3])
+{
+    lastPrecessJD = num->julianDay();
+
+    setEclipticPosition(num, helio, earth);
+    finishPosition(num, lat, LST);
+}
+
+void KSPlanetBase::setEclipticPosition(const KSNumbers *num, const double helio[3], const double *earth)
+{
+    double xh = helio[0], yh = helio[1], zh = helio[2];
+    double r  = sqrt(xh * xh + yh * yh + zh * zh);
+
+    //the spherical heliocentric ecliptic coordinates:
+    helEcPos.longitude.setRadians(atan2(yh, xh));
+    helEcPos.longitude.reduceToRange(dms::ZERO_TO_2PI);
+    helEcPos.latitude.setRadians(atan2(zh, r));
+    setRsun(r);
+
+    if (earth)
+    {
+        //convert to geocentric ecliptic coordinates by subtracting Earth's coords:
+        xh -= earth[0];
+        yh -= earth[1];
+        zh -= earth[2];
+        setRearth(sqrt(xh * xh + yh * yh + zh * zh));
+    }
+
+    //the spherical geocentric ecliptic coordinates:
+    double rr = sqrt(xh * xh + yh * yh);
+    ep.longitude.setRadians(atan2(yh, xh));
+    ep.longitude.reduceToRange(dms::ZERO_TO_2PI);
+    ep.latitude.setRadians(atan2(zh, rr));
+
+    EclipticToEquatorial(num->obliquity());
+
+    // The calculations above produce J2000 results, so we have to precess as well.
+    // This is apparentCoord(J2000, lastPrecessJD), without computing num again.
+    setRA0(ra());
+    setDec0(dec());
+    if (num->julianDay() == lastPrecessJD)
+    {
+        precess(num);
+        nutate(num);
+        if (Options::useRelativistic() && checkBendLight())
+            bendlight();
+        aberrate(num);
+    }
+    else
+        apparentCoord(J2000, lastPrecessJD);
+}
+
+void KSPlanetBase::finishPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST)
+{
     findPhase();
     setAngularSize(findAngularSize()); //angular size in arcmin
 
@@ -182,6 +182,22 @@ class KSPlanetBase : public TrailObject
     void findPosition(const KSNumbers *num, const CachingDms *lat = nullptr, const CachingDms *LST = nullptr,
                       const KSPlanetBase *Earth = nullptr);
 
+    /**
+     * @short Find position from a heliocentric position solved elsewhere.
+     *
+     * Does what findPosition() does, except that the heliocentric position of the body is given
+     * instead of being computed from its orbit. Used by OrbitPropagator, which solves the orbits
+     * of many bodies at once.
+     * @param num KSNumbers pointer for the target date/time
+     * @param lat pointer to the geographic latitude; if nullptr, we skip localizeCoords()
+     * @param LST pointer to the local sidereal time; if nullptr, we skip localizeCoords()
+     * @param helio heliocentric ecliptic J2000 cartesian coordinates of the body, in AU
+     * @param earth heliocentric ecliptic J2000 cartesian coordinates of the Earth, in AU, or nullptr
+     * to leave the coordinates heliocentric
+     */
+    void setHeliocentricPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST,
+                                 const double helio[3], const double earth[3]);
+
     /** @return the Planet's position angle. */
     double pa() const override { return PositionAngle; }
 
@@ -244,6 +260,16 @@ class KSPlanetBase : public TrailObject
      */
     virtual bool findGeocentricPosition(const KSNumbers *num, const KSPlanetBase *Earth = nullptr) = 0;
 
+    /**
+     * @short Set the ecliptic and equatorial coordinates from heliocentric cartesian coordinates.
+     * Meant for the bodies whose orbit is given by orbital elements.
+     * @param num pointer to current KSNumbers object
+     * @param helio heliocentric ecliptic J2000 cartesian coordinates of the body, in AU
+     * @param earth heliocentric ecliptic J2000 cartesian coordinates of the Earth, in AU, or nullptr
+     * to leave the coordinates heliocentric
+     */
+    virtual void setEclipticPosition(const KSNumbers *num, const double helio[3], const double *earth);
+
     /**
      * @short Computes the visual magnitude for the major planets.
      * @param num pointer to a ksnumbers object. Needed for the saturn rings contribution to
@@ -271,18 +297,21 @@ class KSPlanetBase : public TrailObject
     double Phase {NaN::d};
     QImage m_image;
 
-  private:
     /**
      * @short correct the position for the fact that the location is not at the center of the Earth,
      * but a position on its surface.  This causes a small parallactic shift in a solar system
      * body's apparent position.  The effect is most significant for the Moon.
-     * This function is private, and should only be called from the public findPosition() function.
+     * This function should only be called from findPosition() and its specialized variants.
      * @param num pointer to a ksnumbers object for the target date/time
      * @param lat pointer to the geographic latitude of the location.
      * @param LST pointer to the local sidereal time.
      */
     void localizeCoords(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST);
 
+  private:
+    /** @short The part of findPosition() that follows the computation of the geocentric position */
+    void finishPosition(const KSNumbers *num, const CachingDms *lat, const CachingDms *LST);
+
     double PositionAngle, AngularSize, PhysicalSize;
     QColor m_Color;
 };
@@ -234,23 +234,35 @@ dms SkyObject::riseSetTimeAz(const KStarsDateTime &dt, const GeoLocation *geo, b
     return Azimuth;
 }
 
-QTime SkyObject::transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo) const
+double SkyObject::refineHourAngleOffset(const KStarsDateTime &dt, const GeoLocation *geo, double targetHA,
+                                        bool reduce) const
 {
+    // Sidereal seconds elapse faster than solar seconds
+    const double siderealRate = 1.00273790934;
+
     dms LST = geo->GSTtoLST(dt.gst());
 
-    //dSec is the number of seconds until the object transits.
-    dms HourAngle = dms(LST.Degrees() - ra().Degrees());
-    int dSec      = int(-3600. * HourAngle.Hours());
+    //dH is the hour angle the object has yet to travel
+    auto offset = [&](const dms &ra)
+    {
+        dms dH = dms(targetHA - (LST.Degrees() - ra.Degrees()));
+        return reduce ? 3600. * dH.reduce().Hours() / siderealRate : 3600. * dH.Hours();
+    };
 
-    //dt0 is the first guess at the transit time.
-    KStarsDateTime dt0 = dt.addSecs(dSec);
+    //dt0 is the first guess at the requested time
+    KStarsDateTime dt0 = dt.addSecs(offset(ra()));
 
-    //recompute object's position at UT0 and then find
-    //transit time of this refined position
+    //recompute object's position at dt0 and then find
+    //the time of this refined position
     SkyPoint sp = recomputeCoords(dt0, geo);
 
-    HourAngle = dms(LST.Degrees() - sp.ra().Degrees());
-    dSec      = int(-3600. * HourAngle.Hours());
+    return offset(sp.ra());
+}
+
+QTime SkyObject::transitTimeUT(const KStarsDateTime &dt, const GeoLocation *geo) const
+{
+    //dSec is the number of seconds until the object transits, negative if it already did.
+    int dSec = int(refineHourAngleOffset(dt, geo, 0.0, false));
 
     return dt.addSecs(dSec).time();
 }
@@ -272,6 +284,57 @@ dms SkyObject::transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo)
     return dms(delta);
 }
 
+KStarsDateTime SkyObject::hourAngleTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, double hourAngle) const
+{
+    return dt.addSecs(refineHourAngleOffset(dt, geo, hourAngle, true));
+}
+
+bool SkyObject::altitudeCrossingUT(const KStarsDateTime &dt, const GeoLocation *geo, double altitude, bool rising,
+                                   KStarsDateTime &crossing) const
+{
+    // Angular velocity of the Earth, in radians per second
+    const double Wearth = 7.29211510e-5;
+
+    dms h0(altitude);
+    double H = approxHourAngle(&h0, geo->lat(), &dec());
+
+    // Always above or always below the requested altitude
+    if (std::isnan(H))
+        return false;
+
+    KStarsDateTime dt0 = hourAngleTimeUT(dt, geo, rising ? -H : H);
+
+    double sinLat, cosLat;
+    geo->lat()->SinCos(sinLat, cosLat);
+
+    // Newton iterations on the altitude, considering the object moves with the rotation of the Earth only
+    for (int i = 0; i < 4; i++)
+    {
+        SkyPoint sp    = recomputeCoords(dt0, geo);
+        CachingDms LST = geo->GSTtoLST(dt0.gst());
+
+        double sinDec, cosDec, sinHA, cosHA;
+        sp.dec().SinCos(sinDec, cosDec);
+        dms(LST.Degrees() - sp.ra().Degrees()).SinCos(sinHA, cosHA);
+
+        double const alt  = asin(sinDec * sinLat + cosDec * cosLat * cosHA);
+        double const rate = -cosDec * cosLat * sinHA * Wearth / cos(alt);
+
+        // Too close to culmination for the slope to be of any use, the first guess will do
+        if (fabs(rate) < 1e-12)
+            break;
+
+        double const step = (h0.radians() - alt) / rate;
+        dt0               = dt0.addSecs(step);
+
+        if (fabs(step) < 1.0)
+            break;
+    }
+
+    crossing = dt0;
+    return true;
+}
+
 double SkyObject::approxHourAngle(const dms *h0, const dms *gLat, const dms *dec) const
 {
     double sh0 = sin(h0->radians());
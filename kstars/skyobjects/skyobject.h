@@ -286,6 +286,34 @@ class SkyObject : public SkyPoint
      */
     dms transitAltitude(const KStarsDateTime &dt, const GeoLocation *geo) const;
 
+    /**
+     * The first guess is made from the current coordinates of the object, and is refined
+     * once with the coordinates recomputed at that guess, as in transitTimeUT().
+     * @return the next universal date/time at which the object has the given hour angle.
+     * @param dt  date/time to start searching from
+     * @param geo pointer to the geographic location
+     * @param hourAngle hour angle to reach, in degrees (0 for the transit, 180 for the lower culmination)
+     */
+    KStarsDateTime hourAngleTimeUT(const KStarsDateTime &dt, const GeoLocation *geo, double hourAngle) const;
+
+    /**
+     * Determine the next time at which the object crosses the given altitude.
+     *
+     * The hour angle at which a point of fixed declination reaches an altitude has a closed
+     * form, which gives a first guess through hourAngleTimeUT(). The guess is then refined with
+     * a few Newton steps on the altitude of the coordinates recomputed at each step, so that
+     * the motion of solar system objects is accounted for.
+     * @return false if the object never crosses the altitude because it is always above or
+     * always below it, true otherwise.
+     * @param dt  date/time to start searching from
+     * @param geo pointer to the geographic location
+     * @param altitude geometric altitude to cross, in degrees
+     * @param rising If true, find when the object climbs above the altitude. If false, when it sinks below it.
+     * @param crossing set to the universal date/time of the crossing, if any
+     */
+    bool altitudeCrossingUT(const KStarsDateTime &dt, const GeoLocation *geo, double altitude, bool rising,
+                            KStarsDateTime &crossing) const;
+
     /**
      * The equatorial coordinates for the object on date dt are computed and returned,
      * but the object's internal coordinates are not modified.
@@ -408,10 +436,24 @@ class SkyObject : public SkyPoint
      */
     dms auxRiseSetTimeLST(const dms *gLt, const dms *rga, const dms *decl, bool rst) const;
 
+    /**
+     * Find the time the object takes to reach an hour angle. The first guess is made from the
+     * current coordinates of the object, and is refined once with the coordinates recomputed
+     * at that guess.
+     * @param dt  date/time to start from
+     * @param geo pointer to the geographic location
+     * @param targetHA hour angle to reach, in degrees
+     * @param reduce if true, the next time the hour angle is reached, up to a sidereal day after dt.
+     * Otherwise the one given by the signed difference of hour angles, before or after dt, taking
+     * hour angle for time as transitTimeUT() does.
+     * @return the offset from dt, in seconds.
+     */
+    double refineHourAngleOffset(const KStarsDateTime &dt, const GeoLocation *geo, double targetHA, bool reduce) const;
+
     /**
      * Compute the approximate hour angle that an object with declination d will have
      * when its altitude is h (as seen from geographic latitude gLat).
-     * This function is only used by auxRiseSetTimeLST().
+     * This function is only used by auxRiseSetTimeLST() and altitudeCrossingUT().
      * @param h pointer to the altitude of the object
      * @param gLat pointer to the geographic latitude
      * @param d pointer to the declination of the object.
@@ -60,6 +60,36 @@ void SkyPoint::set(const dms &r, const dms &d)
     lastPrecessJD = J2000; // By convention, we use J2000 coordinates
 }
 
+namespace
+{
+// Number of points converted together by the bulk EquatorialToHorizontal(), small enough for the
+// intermediate arrays to stay in the L1 cache
+const int horizontalBlock = 256;
+
+// Single precision atan2() without branches, so that loops calling it get vectorized. Uses the
+// polynomial approximation of atan() on [0, 1] of Abramowitz & Stegun 4.4.49, good to 2e-8 rad.
+inline float fastAtan2(float y, float x)
+{
+    const float ax = std::fabs(x), ay = std::fabs(y);
+    const float a  = std::min(ax, ay) / std::max(std::max(ax, ay), 1e-30f);
+    const float s  = a * a;
+
+    float r = 0.0028662257f;
+    r       = r * s - 0.0161657367f;
+    r       = r * s + 0.0429096138f;
+    r       = r * s - 0.0752896400f;
+    r       = r * s + 0.1065626393f;
+    r       = r * s - 0.1420889944f;
+    r       = r * s + 0.1999355085f;
+    r       = r * s - 0.3333314528f;
+    r       = (r * s + 1.0f) * a;
+
+    r = ay > ax ? 1.57079632679f - r : r;
+    r = x < 0 ? 3.14159265359f - r : r;
+    return y < 0 ? -r : r;
+}
+}
+
 void SkyPoint::EquatorialToHorizontal(const dms *LST, const dms *lat)
 {
     //    qDebug() << "NOTE: This EquatorialToHorizontal overload (using dms pointers instead of CachingDms pointers) is deprecated and should be replaced with CachingDms prototype wherever speed is desirable!";
@@ -133,6 +163,65 @@ void SkyPoint::EquatorialToHorizontal(const CachingDms *LST, const CachingDms *l
     // 	Az.setRadians( atan2( yr, xr ) );
 }
 
+void SkyPoint::EquatorialToHorizontal(SkyPoint *const *points, int count, const CachingDms *LST,
+                                      const CachingDms *lat, bool fast)
+{
+    double sinLST, cosLST, sinlat, coslat;
+    LST->SinCos(sinLST, cosLST);
+    lat->SinCos(sinlat, coslat);
+
+    // Rows of the rotation taking the equatorial unit vector (cosDec cosRA, cosDec sinRA, sinDec)
+    // to the horizontal one (towards north, east and zenith). Azimuth is counted from north to east.
+    const double north[3]  = { -sinlat * cosLST, -sinlat * sinLST, coslat };
+    const double east[2]   = { -sinLST, cosLST };
+    const double zenith[3] = { coslat * cosLST, coslat * sinLST, sinlat };
+
+    double x[horizontalBlock], y[horizontalBlock], z[horizontalBlock];
+    double AltRad[horizontalBlock], AzRad[horizontalBlock];
+
+    for (int start = 0; start < count; start += horizontalBlock)
+    {
+        SkyPoint *const *block = points + start;
+        const int n            = std::min(horizontalBlock, count - start);
+
+        for (int i = 0; i < n; ++i)
+        {
+            double sinra, cosra, sindec, cosdec;
+            block[i]->ra().SinCos(sinra, cosra);
+            block[i]->dec().SinCos(sindec, cosdec);
+
+            const double ex = cosdec * cosra, ey = cosdec * sinra;
+            x[i] = north[0] * ex + north[1] * ey + north[2] * sindec;
+            y[i] = east[0] * ex + east[1] * ey;
+            z[i] = zenith[0] * ex + zenith[1] * ey + zenith[2] * sindec;
+        }
+
+        if (fast)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                const float xf = x[i], yf = y[i];
+                AltRad[i]      = fastAtan2(float(z[i]), std::sqrt(xf * xf + yf * yf));
+                AzRad[i]       = fastAtan2(yf, xf);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                AltRad[i] = asin(std::max(-1.0, std::min(1.0, z[i])));
+                AzRad[i]  = atan2(y[i], x[i]);
+            }
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            block[i]->Alt.setRadians(AltRad[i]);
+            block[i]->Az.setRadians(AzRad[i] < 0.0 ? AzRad[i] + 2.0 * dms::PI : AzRad[i]);
+        }
+    }
+}
+
 void SkyPoint::HorizontalToEquatorial(const dms *LST, const dms *lat)
 {
     double HARad, DecRad;
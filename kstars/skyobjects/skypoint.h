@@ -243,6 +243,22 @@ class SkyPoint
      */
     void EquatorialToHorizontal(const CachingDms *LST, const CachingDms *lat);
 
+    /**
+     * Determine the (Altitude, Azimuth) coordinates of many SkyPoints at once.
+     *
+     * The rotation from equatorial to horizontal coordinates is set up once for the given
+     * local sidereal time and latitude, and applied to the cached sines and cosines of (RA, Dec)
+     * of each point, so only the inverse trigonometric functions remain to be done per point.
+     * @param points array of the points to convert
+     * @param count number of points in the array
+     * @param LST pointer to the local sidereal time
+     * @param lat pointer to the geographic latitude
+     * @param fast if true, use a single precision approximation, good to about 0.1 arcsecond.
+     * Only meant for points that are drawn and not otherwise used, like the vertices of lines.
+     */
+    static void EquatorialToHorizontal(SkyPoint *const *points, int count, const CachingDms *LST,
+                                       const CachingDms *lat, bool fast = false);
+
     // Deprecated method provided for compatibility
     void EquatorialToHorizontal(const dms *LST, const dms *lat);
 
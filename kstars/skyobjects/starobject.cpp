@@ -295,8 +295,6 @@ void StarObject::updateCoords(const KSNumbers *num, bool, const CachingDms *, co
 
 bool StarObject::getIndexCoords(const KSNumbers *num, CachingDms &ra, CachingDms &dec)
 {
-    static double pmms;
-
     // =================== NOTE: CODE DUPLICATION ====================
     // If you modify this, please also modify the other getIndexCoords
     // ===============================================================
@@ -328,7 +326,7 @@ bool StarObject::getIndexCoords(const KSNumbers *num, CachingDms &ra, CachingDms
     // atan2( pmRA(), pmDec() ) to an angular distance given by the Magnitude of
     // PM times the number of Julian millenia since J2000.0
 
-    pmms = pmMagnitudeSquared();
+    double pmms = pmMagnitudeSquared();
 
     if (std::isnan(pmms) || pmms * num->julianMillenia() * num->julianMillenia() < 1.)
     {
@@ -371,8 +369,6 @@ bool StarObject::getIndexCoords(const KSNumbers *num, CachingDms &ra, CachingDms
 
 bool StarObject::getIndexCoords(const KSNumbers *num, double *ra, double *dec)
 {
-    static double pmms;
-
     // =================== NOTE: CODE DUPLICATION ====================
     // If you modify this, please also modify the other getIndexCoords
     // ===============================================================
@@ -403,7 +399,7 @@ bool StarObject::getIndexCoords(const KSNumbers *num, double *ra, double *dec)
     // atan2( pmRA(), pmDec() ) to an angular distance given by the Magnitude of
     // PM times the number of Julian millenia since J2000.0
 
-    pmms = pmMagnitudeSquared();
+    double pmms = pmMagnitudeSquared();
 
     if (std::isnan(pmms) || pmms * num->julianMillenia() * num->julianMillenia() < 1.)
     {
@@ -471,6 +467,19 @@ void StarObject::JITupdate()
     updateID = data->updateID();
 }
 
+void StarObject::setUpdatedCoords(double sinRA, double cosRA, double sinDec, double jd)
+{
+    CachingDms ra, dec;
+
+    ra.setUsing_atan2(sinRA, cosRA);
+    ra.reduceToRange(dms::ZERO_TO_2PI);
+    dec.setUsing_asin(sinDec);
+
+    setRA(ra);
+    setDec(dec);
+    lastPrecessJD = jd;
+}
+
 QString StarObject::sptype(void) const
 {
     return QString(QByteArray(SpType, 2));
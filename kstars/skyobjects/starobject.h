@@ -196,6 +196,15 @@ class StarObject : public SkyObject
     /** @short added for JIT updates from both StarComponent and ConstellationLines */
     void JITupdate();
 
+    /**
+     * @short Set the current coordinates computed outside of updateCoords(), see StarBlock::JITupdate()
+     * @param sinRA sine of the current right ascension
+     * @param cosRA cosine of the current right ascension
+     * @param sinDec sine of the current declination
+     * @param jd Julian Day the coordinates were computed for
+     */
+    void setUpdatedCoords(double sinRA, double cosRA, double sinDec, double jd);
+
     /** @short returns the magnitude of the proper motion correction in milliarcsec/year */
     inline double pmMagnitude() const
     {
@@ -37,6 +37,7 @@ class SkipHashList;
 class SkyMap;
 class SkyObject;
 class SkyPoint;
+class StarObject;
 class Supernova;
 
 /**
@@ -128,6 +129,23 @@ class SkyPainter
      */
     virtual bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') = 0;
 
+    /**
+     * @short Draw a batch of point sources, e.g. the stars of a StarBlock.
+     * The default implementation calls drawPointSource() for each star.
+     * @param stars the stars to draw, null entries are skipped
+     * @param count the number of stars
+     * @param drawn if not null, receives for each star whether it was drawn
+     * @return the number of stars drawn
+     */
+    virtual int drawPointSources(StarObject *const *stars, int count, bool *drawn = nullptr);
+
+    /**
+     * @short Finish drawing the point sources of drawPointSources().
+     * Painters may queue point sources to draw them all at once, components drawing stars call
+     * this once they are done. The default implementation does nothing.
+     */
+    virtual void flushPointSources() {}
+
     /**
      * @short Draw a deep sky object
      * @param obj the object to draw
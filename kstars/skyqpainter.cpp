@@ -19,7 +19,12 @@
 
 #include "skyqpainter.h"
 
+#include <QElapsedTimer>
 #include <QPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <numeric>
 
 #include "kstarsdata.h"
 #include "Options.h"
@@ -39,6 +44,7 @@
 #include "skyobjects/kscomet.h"
 #include "skyobjects/kssun.h"
 #include "skyobjects/satellite.h"
+#include "skyobjects/starobject.h"
 #include "skyobjects/supernova.h"
 #include "skyobjects/ksearthshadow.h"
 #include "hips/hipsrenderer.h"
@@ -89,6 +95,26 @@ const int nSPclasses = 7;
 // These pixmaps are never deallocated. Not really good...
 QPixmap *imageCache[nSPclasses][nStarSizes] = { { nullptr } };
 
+// All star images in a single pixmap, one row per spectral class and one cell per size,
+// so that all the stars of a component can be drawn in one drawPixmapFragments() call.
+const int starAtlasCell = nStarSizes;
+std::unique_ptr<QPixmap> starAtlas;
+// Copy of the atlas for the painters of tiled rendering, as pixmaps are not to be used outside the GUI thread
+std::unique_ptr<QImage> starAtlasImage;
+
+// Below this many queued stars, drawing them in a single pass is faster than splitting them in tiles
+const int minTiledStars = 2000;
+// Tiles thinner than this are not worth a thread of their own
+const int minTileHeight = 64;
+
+#ifdef PROFILE_STARDRAW
+// Alternate frames between the atlas and drawing each star image, to compare both
+bool profileStarAtlas = true;
+qint64 profileStarTime[2] = { 0, 0 };
+qint64 profileStarCount[2] = { 0, 0 };
+int profileStarFrames[2] = { 0, 0 };
+#endif
+
 std::unique_ptr<QPixmap> visibleSatPixmap, invisibleSatPixmap;
 }
 
@@ -110,6 +136,9 @@ void SkyQPainter::releaseImageCache()
             pmap[size] = nullptr;
         }
     }
+
+    starAtlas.reset();
+    starAtlasImage.reset();
 }
 
 SkyQPainter::SkyQPainter(QPaintDevice *pd) : SkyPainter(), QPainter()
@@ -153,7 +182,20 @@ void SkyQPainter::begin()
 
 void SkyQPainter::end()
 {
+    flushPointSources();
     QPainter::end();
+
+#ifdef PROFILE_STARDRAW
+    int const mode = profileStarAtlas ? 1 : 0;
+    profileStarFrames[mode]++;
+    if (profileStarFrames[0] > 0 && profileStarFrames[1] > 0 && (profileStarFrames[0] + profileStarFrames[1]) % 20 == 0)
+    {
+        for (int i = 0; i < 2; i++)
+            qDebug() << (i ? "Star atlas:" : "Star images:") << profileStarFrames[i] << "frames," << profileStarCount[i] / profileStarFrames[i]
+                     << "stars and" << profileStarTime[i] / profileStarFrames[i] / 1000 << "us per frame";
+    }
+    profileStarAtlas = !profileStarAtlas;
+#endif
 }
 
 void SkyQPainter::drawSkyBackground()
@@ -263,6 +305,21 @@ void SkyQPainter::initStarImages()
     }
     starColorMode = Options::starColorMode();
 
+    // Gather the star images in the atlas
+    QPixmap atlas(starAtlasCell * nStarSizes, starAtlasCell * nSPclasses);
+    atlas.fill(Qt::transparent);
+    QPainter p(&atlas);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    for (char &color : ColorMap.keys())
+    {
+        int const row = harvardToIndex(color);
+        for (int size = 1; size < nStarSizes; size++)
+            p.drawPixmap(size * starAtlasCell, row * starAtlasCell, *imageCache[row][size]);
+    }
+    p.end();
+    starAtlas.reset(new QPixmap(atlas));
+    starAtlasImage.reset(new QImage(atlas.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied)));
+
     if (!visibleSatPixmap.get())
         visibleSatPixmap.reset(new QPixmap(":/icons/kstars_satellites_visible.svg"));
     if (!invisibleSatPixmap.get())
@@ -578,6 +635,125 @@ bool SkyQPainter::drawPointSource(SkyPoint *loc, float mag, char sp)
     }
 }
 
+int SkyQPainter::drawPointSources(StarObject *const *stars, int count, bool *drawn)
+{
+    // Reused across calls, the painting threads each have their own
+    thread_local QVector<Vector2f> screen;
+    thread_local QVector<bool> visible;
+    screen.resize(count);
+    visible.resize(count);
+
+#ifdef PROFILE_STARDRAW
+    QElapsedTimer timer;
+    timer.start();
+#endif
+
+    int const visibleCount = m_proj->toScreenBatch(stars, count, screen.data(), visible.data());
+
+    if (drawn)
+        std::copy(visible.constBegin(), visible.constEnd(), drawn);
+
+    if (visibleCount == 0)
+        return 0;
+
+    // Stars drawn as bitmaps are queued as sprites of the star atlas, vector stars are drawn one by one
+    bool useAtlas = (!m_vectorStars || starColorMode == 0) && starAtlas;
+#ifdef PROFILE_STARDRAW
+    useAtlas &= profileStarAtlas;
+#endif
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!visible[i])
+            continue;
+
+        QPointF const pos(screen[i].x(), screen[i].y());
+        float const size = starWidth(stars[i]->mag());
+
+        if (useAtlas)
+        {
+            int const isize = qMin(static_cast<int>(size), nStarSizes - 1);
+            QRectF const source(isize * starAtlasCell, harvardToIndex(stars[i]->spchar()) * starAtlasCell, isize, isize);
+            m_starFragments.append(QPainter::PixmapFragment::create(pos, source));
+        }
+        else
+            drawPointSource(pos, size, stars[i]->spchar());
+    }
+
+#ifdef PROFILE_STARDRAW
+    profileStarTime[profileStarAtlas ? 1 : 0] += timer.nsecsElapsed();
+    profileStarCount[profileStarAtlas ? 1 : 0] += visibleCount;
+#endif
+
+    return visibleCount;
+}
+
+void SkyQPainter::flushPointSources()
+{
+    if (m_starFragments.isEmpty())
+        return;
+
+#ifdef PROFILE_STARDRAW
+    QElapsedTimer timer;
+    timer.start();
+#endif
+
+    if (Options::tiledSkyMap() && m_pd->devType() == QInternal::Image && m_starFragments.size() >= minTiledStars)
+        drawPointSourcesTiled(static_cast<QImage *>(m_pd));
+    else
+        drawPixmapFragments(m_starFragments.constData(), m_starFragments.size(), *starAtlas);
+    m_starFragments.clear();
+
+#ifdef PROFILE_STARDRAW
+    profileStarTime[1] += timer.nsecsElapsed();
+#endif
+}
+
+void SkyQPainter::drawPointSourcesTiled(QImage *image)
+{
+    int const height       = image->height();
+    int const tiles        = qBound(1, QThreadPool::globalInstance()->maxThreadCount(), height / minTileHeight);
+    int const tileHeight   = (height + tiles - 1) / tiles;
+    int const bytesPerLine = image->bytesPerLine();
+    uchar *const bits      = image->bits();
+
+    QTransform const world  = transform();
+    bool const clipped      = hasClipping();
+    QPainterPath const clip = clipped ? clipPath() : QPainterPath();
+    RenderHints const hints = renderHints();
+    QVector<QPainter::PixmapFragment> const &fragments = m_starFragments;
+
+    QVector<int> tileIndex(tiles);
+    std::iota(tileIndex.begin(), tileIndex.end(), 0);
+
+    QtConcurrent::blockingMap(tileIndex, [&](int tile)
+    {
+        int const top  = tile * tileHeight;
+        int const rows = qMin(tileHeight, height - top);
+        if (rows <= 0)
+            return;
+
+        // The tile shares the rows of the sky image, so there is nothing to composite afterwards
+        QImage tileImage(bits + top * bytesPerLine, image->width(), rows, bytesPerLine, image->format());
+        QPainter p(&tileImage);
+        p.setRenderHints(hints);
+        p.translate(0, -top);
+        p.setTransform(world, true);
+        if (clipped)
+            p.setClipPath(clip);
+
+        for (auto const &fragment : fragments)
+        {
+            QPointF const center = world.map(QPointF(fragment.x, fragment.y));
+            if (center.y() + fragment.height < top || center.y() - fragment.height > top + rows)
+                continue;
+
+            QRectF const source(fragment.sourceLeft, fragment.sourceTop, fragment.width, fragment.height);
+            p.drawImage(QPointF(fragment.x - 0.5 * fragment.width, fragment.y - 0.5 * fragment.height), *starAtlasImage, source);
+        }
+    });
+}
+
 void SkyQPainter::drawPointSource(const QPointF &pos, float size, char sp)
 {
     int isize = qMin(static_cast<int>(size), 14);
@@ -23,6 +23,9 @@
 
 #include <QColor>
 #include <QMap>
+#include <QVector>
+
+//#define PROFILE_STARDRAW
 
 class Projector;
 class QWidget;
@@ -87,6 +90,8 @@ class SkyQPainter : public SkyPainter, public QPainter
                          LineListLabel *label = nullptr) override;
     void drawSkyPolygon(LineList *list, bool forceClip = true) override;
     bool drawPointSource(SkyPoint *loc, float mag, char sp = 'A') override;
+    int drawPointSources(StarObject *const *stars, int count, bool *drawn = nullptr) override;
+    void flushPointSources() override;
     bool drawDeepSkyObject(DeepSkyObject *obj, bool drawImage = false) override;
     bool drawPlanet(KSPlanetBase *planet) override;
     bool drawEarthShadow(KSEarthShadow *shadow) override;
@@ -105,9 +110,18 @@ class SkyQPainter : public SkyPainter, public QPainter
 private:
     virtual bool drawDeepSkyImage(const QPointF &pos, DeepSkyObject *obj, float positionAngle);
 
+    /**
+     * @short Draw the queued star sprites into horizontal bands of the target image in parallel
+     * Each band gets its own QPainter, with the transformation and clipping of this painter.
+     * @param image The paint device of this painter
+     */
+    void drawPointSourcesTiled(QImage *image);
+
     QPaintDevice *m_pd { nullptr };
     const Projector *m_proj { nullptr };
     bool m_vectorStars { false };
+    /// Star sprites queued by drawPointSources(), drawn from the star atlas by flushPointSources()
+    QVector<QPainter::PixmapFragment> m_starFragments;
     HIPSRenderer *m_hipsRender { nullptr };
     QSize m_size;
     static int starColorMode;
@@ -34,6 +34,7 @@
 #include "dialogs/locationdialog.h"
 #include "skycomponents/skymapcomposite.h"
 #include "skyobjects/kscomet.h"
+#include "skyobjects/ksplanet.h"
 #include "skyobjects/kspluto.h"
 #include "ksplanetbase.h"
 
@@ -86,10 +87,8 @@ ConjunctionsTool::ConjunctionsTool(QWidget *parentSplit) : QFrame(parentSplit)
     connect(ModeSelector, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &ConjunctionsTool::setMode);
 
     //connect(ComputeButton, SIGNAL(clicked()), this, SLOT(slotCompute()));
-    connect(ComputeButton, &QPushButton::clicked, [this]()
-    {
-        QtConcurrent::run(this, &ConjunctionsTool::slotCompute);
-    });
+    connect(ComputeButton, &QPushButton::clicked, this, &ConjunctionsTool::slotCompute);
+    connect(&m_Watcher, &QFutureWatcher<void>::finished, this, &ConjunctionsTool::slotComputeFinished);
     connect(FilterTypeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(slotFilterType(int)));
     connect(ClearButton, SIGNAL(clicked()), this, SLOT(slotClear()));
     connect(ExportButton, SIGNAL(clicked()), this, SLOT(slotExport()));
@@ -141,6 +140,13 @@ ConjunctionsTool::ConjunctionsTool(QWidget *parentSplit) : QFrame(parentSplit)
     show();
 }
 
+ConjunctionsTool::~ConjunctionsTool()
+{
+    // The search threads use the members of the tool
+    m_Watcher.cancel();
+    m_Watcher.waitForFinished();
+}
+
 void ConjunctionsTool::slotGoto()
 {
     int index      = m_SortModel->mapToSource(OutputList->currentIndex()).row(); // Get the number of the line
@@ -245,6 +251,9 @@ void ConjunctionsTool::slotFilterReg(const QString &filter)
 
 void ConjunctionsTool::slotCompute(void)
 {
+    if (m_Watcher.isRunning())
+        return;
+
     KStarsDateTime dtStart(startDate->dateTime()); // Start date
     KStarsDateTime dtStop(stopDate->dateTime());  // Stop date
     long double startJD    = dtStart.djd();         // Start julian day
@@ -254,7 +263,6 @@ void ConjunctionsTool::slotCompute(void)
         opposition = true;
     QStringList objects; // List of sky object used as Object1
     KStarsData *data = KStarsData::Instance();
-    int progress     = 0;
 
     // Check if we have a valid angle in maxSeparationBox
     dms maxSeparation(0.0);
@@ -282,11 +290,6 @@ void ConjunctionsTool::slotCompute(void)
         return;
     }
 
-    // Init KSConjunct object
-    KSConjunct ksc;
-    connect(&ksc, SIGNAL(madeProgress(int)), this, SLOT(showProgress(int)));
-    ksc.setGeoLocation(geoPlace);
-
     switch (FilterTypeComboBox->currentIndex())
     {
         case 1: // All object types
@@ -353,37 +356,53 @@ void ConjunctionsTool::slotCompute(void)
         objects.removeAll("Iapetus");
     }
 
-    ksc.setMaxSeparation(maxSeparation);
-    ksc.setObject2(Object2);
-    ksc.setOpposition(opposition);
+    m_StartJD       = startJD;
+    m_StopJD        = stopJD;
+    m_MaxSeparation = maxSeparation;
+    m_Opposition    = opposition;
+
+    // Load the orbital data of the planets now, as loading them is not thread-safe. The positions
+    // of the planets, and of the Earth for the Sun, are then served by ephemeris caches shared by
+    // all the threads, see ChebyshevEphemeris.
+    Object2->loadData();
+    KSPlanet(i18n("Earth")).loadData();
 
+    // Copy the objects of all the pairs here, and destroy them in slotComputeFinished() once the search is over,
+    // as the Moon shares its lunar tables between its instances without locking them
     if (FilterTypeComboBox->currentIndex() != 0)
     {
-        // Show a progress dialog while processing
-        QProgressDialog progressDlg(i18n("Compute conjunction..."), i18n("Abort"), 0, objects.count(), this);
-        progressDlg.setWindowTitle(i18n("Conjunction"));
-        progressDlg.setWindowModality(Qt::WindowModal);
-        progressDlg.setValue(0);
-
-        for (auto &object : objects)
+        m_Pairs.reserve(objects.count());
+        for (const QString &object : objects)
         {
-            // If the user click on the 'cancel' button
-            if (progressDlg.wasCanceled())
-                break;
-
-            // Update progress dialog
-            ++progress;
-            progressDlg.setValue(progress);
-            progressDlg.setLabelText(i18n("Compute conjunction between %1 and %2", Object2->name(), object));
-
-            // Compute conjuction
-            Object1 = std::shared_ptr<SkyObject>(data->skyComposite()->findByName(object)->clone());
-            ksc.setObject1(Object1);
-            showConjunctions(ksc.findClosestApproach(startJD, stopJD),
-                             object, Object2->name());
+            SkyObject *found = data->skyComposite()->findByName(object);
+            if (found)
+                m_Pairs.append({ SkyObject_s(found->clone()),
+                                 KSPlanetBase_s(KSPlanetBase::createPlanet(Obj2ComboBox->currentIndex())) });
         }
+    }
+    else
+        m_Pairs.append({ SkyObject_s(Object1->clone()), KSPlanetBase_s(KSPlanetBase::createPlanet(Obj2ComboBox->currentIndex())) });
 
-        progressDlg.setValue(objects.count());
+    ComputeButton->setEnabled(false);
+
+    if (FilterTypeComboBox->currentIndex() != 0)
+    {
+        // Each object is paired with the second object on the global thread pool, and the
+        // conjunctions are added to the table as they are found
+        m_ProgressDialog = new QProgressDialog(i18n("Compute conjunction..."), i18n("Abort"), 0, m_Pairs.count(), this);
+        m_ProgressDialog->setWindowTitle(i18n("Conjunction"));
+        m_ProgressDialog->setWindowModality(Qt::WindowModal);
+        m_ProgressDialog->setLabelText(i18n("Compute conjunctions between %1 and %2 objects", Object2->name(),
+                                            m_Pairs.count()));
+        m_ProgressDialog->setValue(0);
+        connect(&m_Watcher, &QFutureWatcher<void>::progressValueChanged, m_ProgressDialog.data(),
+                &QProgressDialog::setValue);
+        connect(m_ProgressDialog.data(), &QProgressDialog::canceled, &m_Watcher, &QFutureWatcher<void>::cancel);
+
+        m_Watcher.setFuture(QtConcurrent::map(m_Pairs, [this](ConjunctionPair &pair)
+        {
+            findConjunctions(pair, false);
+        }));
     }
     else
     {
@@ -392,15 +411,52 @@ void ConjunctionsTool::slotCompute(void)
 
         ComputeStack->setCurrentIndex(1);
 
-        ksc.setObject1(Object1);
-        showConjunctions(ksc.findClosestApproach(startJD, stopJD),
-                         Object1->name(), Object2->name());
+        m_Watcher.setFuture(QtConcurrent::run([this]()
+        {
+            findConjunctions(m_Pairs[0], true);
+        }));
+    }
+}
+
+void ConjunctionsTool::findConjunctions(ConjunctionPair &pair, bool reportProgress)
+{
+    // The solver belongs to this thread, the objects of the pair are used by this thread only
+    const QString name1 = pair.object1->name(), name2 = pair.object2->name();
+
+    KSConjunct ksc;
+    if (reportProgress)
+        connect(&ksc, &KSConjunct::madeProgress, this, &ConjunctionsTool::showProgress);
+    ksc.setGeoLocation(geoPlace);
+    ksc.setMaxSeparation(m_MaxSeparation);
+    ksc.setObject1(pair.object1);
+    ksc.setObject2(pair.object2);
+    ksc.setOpposition(m_Opposition);
+
+    ksc.findClosestApproach(m_StartJD, m_StopJD, [&](long double jd, dms separation)
+    {
+        QMetaObject::invokeMethod(this, "addConjunction", Qt::QueuedConnection, Q_ARG(double, double(jd)),
+                                  Q_ARG(double, separation.Degrees()), Q_ARG(QString, name1),
+                                  Q_ARG(QString, name2));
+    });
+}
+
+void ConjunctionsTool::slotComputeFinished()
+{
+    if (m_ProgressDialog)
+    {
+        m_ProgressDialog->setValue(m_ProgressDialog->maximum());
+        m_ProgressDialog->deleteLater();
+    }
+    else
+    {
         ComputeStack->setCurrentIndex(0);
 
         // Restore cursor
         QApplication::restoreOverrideCursor();
     }
 
+    ComputeButton->setEnabled(true);
+    m_Pairs.clear();
     Object2.reset();
 }
 
@@ -409,34 +465,29 @@ void ConjunctionsTool::showProgress(int n)
     progress->setValue(n);
 }
 
-void ConjunctionsTool::showConjunctions(const QMap<long double, dms> &conjunctionlist, const QString &object1,
-                                        const QString &object2)
+void ConjunctionsTool::addConjunction(double jd, double separation, const QString &object1, const QString &object2)
 {
     KStarsDateTime dt;
     QList<QStandardItem *> itemList;
 
-    for (auto it = conjunctionlist.constBegin(); it != conjunctionlist.constEnd(); ++it)
-    {
-        dt.setDJD(it.key());
-        QStandardItem *typeItem;
-
-        if (mode == CONJUNCTION)
-            typeItem = new QStandardItem(i18n("Conjunction"));
-        else
-            typeItem = new QStandardItem(i18n("Opposition"));
-
-        itemList << typeItem
-                 //FIXME TODO is this ISO date? is there a ready format to use?
-                 //<< new QStandardItem( QLocale().toString( dt.dateTime(), "YYYY-MM-DDTHH:mm:SS" ) )
-                 //<< new QStandardItem( QLocale().toString( dt, Qt::ISODate) )
-                 << new QStandardItem(dt.toString(Qt::ISODate)) << new QStandardItem(object1)
-                 << new QStandardItem(object2) << new QStandardItem(it.value().toDMSString());
-        m_Model->appendRow(itemList);
-        itemList.clear();
-
-        outputJDList.insert(m_index, it.key());
-        ++m_index;
-    }
+    dt.setDJD(jd);
+    QStandardItem *typeItem;
+
+    if (m_Opposition)
+        typeItem = new QStandardItem(i18n("Opposition"));
+    else
+        typeItem = new QStandardItem(i18n("Conjunction"));
+
+    itemList << typeItem
+             //FIXME TODO is this ISO date? is there a ready format to use?
+             //<< new QStandardItem( QLocale().toString( dt.dateTime(), "YYYY-MM-DDTHH:mm:SS" ) )
+             //<< new QStandardItem( QLocale().toString( dt, Qt::ISODate) )
+             << new QStandardItem(dt.toString(Qt::ISODate)) << new QStandardItem(object1)
+             << new QStandardItem(object2) << new QStandardItem(dms(separation).toDMSString());
+    m_Model->appendRow(itemList);
+
+    outputJDList.insert(m_index, jd);
+    ++m_index;
 }
 
 void ConjunctionsTool::setUpConjunctionOpposition()
@@ -28,11 +28,15 @@
 #include "ui_conjunctions.h"
 
 #include <QFrame>
+#include <QFutureWatcher>
 #include <QMap>
+#include <QPointer>
 #include <QString>
+#include <QVector>
 #include "skycomponents/typedef.h"
 #include <memory>
 
+class QProgressDialog;
 class QSortFilterProxyModel;
 class QStandardItemModel;
 
@@ -51,7 +55,7 @@ class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
 
   public:
     explicit ConjunctionsTool(QWidget *p);
-    virtual ~ConjunctionsTool() override = default;
+    virtual ~ConjunctionsTool() override;
 
   public slots:
 
@@ -66,9 +70,33 @@ class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
     void slotExport();
     void slotFilterReg(const QString &);
 
+  private slots:
+    /**
+     * @short Append a conjunction to the table, as soon as it is found
+     * @param jd Julian Day of the conjunction
+     * @param separation separation of the objects, in degrees
+     */
+    void addConjunction(double jd, double separation, const QString &object1, const QString &object2);
+
+    /** @short Restore the user interface once the search is over */
+    void slotComputeFinished();
+
   private:
-    void showConjunctions(const QMap<long double, dms> &conjunctionlist, const QString &object1,
-                          const QString &object2);
+    /// Copies of the two objects of a pair, created and destroyed on the GUI thread
+    struct ConjunctionPair
+    {
+        SkyObject_s object1;
+        KSPlanetBase_s object2;
+    };
+
+    /**
+     * @short Search the conjunctions of the two objects of a pair
+     * Runs on the global thread pool. The copies of the objects stay owned by the GUI thread, because building
+     * and destroying some of them, like the Moon, is not thread-safe.
+     * @param pair the copies of the two objects
+     * @param reportProgress whether the progress of the search is shown in the progress bar
+     */
+    void findConjunctions(ConjunctionPair &pair, bool reportProgress);
 
     /**
      * @brief setUpConjunctionOpposition
@@ -87,6 +115,16 @@ class ConjunctionsTool : public QFrame, public Ui::ConjunctionsDlg
 
     SkyObject_s Object1;
     KSPlanetBase_s Object2; // Second object is always a planet.
+
+    /// Parameters of the running search, read by the worker threads
+    QVector<ConjunctionPair> m_Pairs;
+    long double m_StartJD { 0 };
+    long double m_StopJD { 0 };
+    dms m_MaxSeparation;
+    bool m_Opposition { false };
+
+    QFutureWatcher<void> m_Watcher;
+    QPointer<QProgressDialog> m_ProgressDialog;
     /// To store the names of Planets vs. values expected by KSPlanetBase::createPlanet()
     QHash<int, QString> pNames;
 